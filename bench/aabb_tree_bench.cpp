@@ -0,0 +1,221 @@
+// Broad phase benchmark, dynamic aabb tree against brute force pair finding.
+// Every step the tree has to find exactly the same pairs. Afterwards some proxies are
+// destroyed, then pairs, box queries and segment casts are checked against brute force.
+// Build from the repository root:
+//   g++ -O2 -std=c++17 bench/aabb_tree_bench.cpp utils/aabb_tree.cpp -o aabb_tree_bench
+
+#include "../utils/aabb_tree.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+using namespace std;
+
+typedef vector<pair<unsigned int, unsigned int>> pair_list;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        printf("FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+struct moving_box {
+    float x;
+    float y;
+    float dx;
+    float dy;
+    float half_size;
+};
+
+static float random_float(float low, float high) {
+    return low + (high - low) * (rand() / (float)RAND_MAX);
+}
+
+static aabb get_box(const moving_box& box) {
+    aabb bounds = {
+        box.x - box.half_size, box.y - box.half_size,
+        box.x + box.half_size, box.y + box.half_size
+    };
+    return bounds;
+}
+
+// Lower id first, then sorted, so pair lists from different sources can be compared
+static void normalize_pairs(pair_list& pairs) {
+    for (pair<unsigned int, unsigned int>& p : pairs) {
+        if (p.first > p.second) {
+            swap(p.first, p.second);
+        }
+    }
+    sort(pairs.begin(), pairs.end());
+}
+
+static pair_list find_pairs_brute_force(const vector<aabb>& bounds, const vector<bool>& alive) {
+    pair_list pairs;
+    for (size_t i = 0; i < bounds.size(); i++) {
+        for (size_t j = i + 1; j < bounds.size() && alive[i]; j++) {
+            if (alive[j] && aabb_overlaps(bounds[i], bounds[j])) {
+                pairs.push_back(make_pair(i, j));
+            }
+        }
+    }
+    return pairs;
+}
+
+// Reference segment test, clips the segment against one side of the box at a time
+static bool clip_segment(const aabb& box, float x1, float y1, float x2, float y2, float* fraction) {
+    float t_enter = 0.0f;
+    float t_exit = 1.0f;
+    float start[2] = {x1, y1};
+    float delta[2] = {x2 - x1, y2 - y1};
+    float low[2] = {box.min_x, box.min_y};
+    float high[2] = {box.max_x, box.max_y};
+    for (int axis = 0; axis < 2; axis++) {
+        if (delta[axis] == 0.0f) {
+            if (start[axis] < low[axis] || start[axis] > high[axis]) {
+                return false;
+            }
+            continue;
+        }
+        float t_low = (low[axis] - start[axis]) / delta[axis];
+        float t_high = (high[axis] - start[axis]) / delta[axis];
+        t_enter = max(t_enter, min(t_low, t_high));
+        t_exit = min(t_exit, max(t_low, t_high));
+    }
+    *fraction = t_enter;
+    return t_enter <= t_exit;
+}
+
+static double elapsed_ms(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+static void run(int n_boxes, int n_steps) {
+    srand(42);
+    float world_size = 100.0f;
+    vector<moving_box> boxes(n_boxes);
+    for (moving_box& box : boxes) {
+        box.x = random_float(0.0f, world_size);
+        box.y = random_float(0.0f, world_size);
+        box.dx = random_float(-0.2f, 0.2f);
+        box.dy = random_float(-0.2f, 0.2f);
+        box.half_size = random_float(0.1f, 0.5f);
+    }
+
+    AABB_TREE tree(0.2f);
+    vector<int> proxies(n_boxes);
+    for (int i = 0; i < n_boxes; i++) {
+        proxies[i] = tree.create_proxy(get_box(boxes[i]), i);
+    }
+
+    double tree_ms = 0.0;
+    double brute_ms = 0.0;
+    size_t tree_pairs = 0;
+    size_t brute_pairs = 0;
+    bool same_pairs = true;
+    pair_list pairs;
+    vector<aabb> bounds(n_boxes);
+    vector<bool> alive(n_boxes, true);
+
+    for (int step = 0; step < n_steps; step++) {
+        for (moving_box& box : boxes) {
+            box.x += box.dx;
+            box.y += box.dy;
+            if (box.x < 0.0f || box.x > world_size) box.dx = -box.dx;
+            if (box.y < 0.0f || box.y > world_size) box.dy = -box.dy;
+        }
+        for (int i = 0; i < n_boxes; i++) {
+            bounds[i] = get_box(boxes[i]);
+        }
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (int i = 0; i < n_boxes; i++) {
+            tree.move_proxy(proxies[i], bounds[i], boxes[i].dx, boxes[i].dy);
+        }
+        tree.find_pairs(pairs);
+        tree_ms += elapsed_ms(start);
+        tree_pairs += pairs.size();
+
+        start = chrono::steady_clock::now();
+        pair_list brute = find_pairs_brute_force(bounds, alive);
+        brute_ms += elapsed_ms(start);
+        brute_pairs += brute.size();
+
+        normalize_pairs(pairs);
+        same_pairs = same_pairs && pairs == brute;
+    }
+
+    printf("%6d boxes: tree %8.3f ms/step  brute force %8.3f ms/step  pairs %zu/%zu  height %d\n",
+        n_boxes, tree_ms / n_steps, brute_ms / n_steps, tree_pairs, brute_pairs, tree.get_height());
+    check(same_pairs, "the tree finds the same pairs as brute force every step");
+
+    // Destroyed proxies must be gone from every kind of query, their nodes get reused by new ones
+    for (int i = 0; i < n_boxes; i += 3) {
+        tree.destroy_proxy(proxies[i]);
+        alive[i] = false;
+    }
+    for (int i = 0; i < n_boxes; i += 6) {
+        proxies[i] = tree.create_proxy(bounds[i], i);
+        alive[i] = true;
+    }
+    tree.find_pairs(pairs);
+    normalize_pairs(pairs);
+    check(pairs == find_pairs_brute_force(bounds, alive), "pairs after destroying and recreating proxies");
+
+    bool same_queries = true;
+    bool same_hits = true;
+    bool ordered = true;
+    vector<unsigned int> found;
+    vector<ray_hit> hits;
+    for (int i = 0; i < 100; i++) {
+        float x = random_float(0.0f, world_size);
+        float y = random_float(0.0f, world_size);
+        aabb box = {x, y, x + random_float(0.0f, 10.0f), y + random_float(0.0f, 10.0f)};
+        tree.query(box, found);
+        sort(found.begin(), found.end());
+        vector<unsigned int> expected;
+        for (int j = 0; j < n_boxes; j++) {
+            if (alive[j] && aabb_overlaps(bounds[j], box)) {
+                expected.push_back(j);
+            }
+        }
+        same_queries = same_queries && found == expected;
+
+        float x2 = random_float(0.0f, world_size);
+        float y2 = random_float(0.0f, world_size);
+        tree.ray_cast(x, y, x2, y2, hits);
+        vector<ray_hit> expected_hits;
+        for (int j = 0; j < n_boxes; j++) {
+            float fraction;
+            if (alive[j] && clip_segment(bounds[j], x, y, x2, y2, &fraction)) {
+                ray_hit hit = {(unsigned int)j, fraction};
+                expected_hits.push_back(hit);
+            }
+        }
+        for (size_t j = 1; j < hits.size(); j++) {
+            ordered = ordered && hits[j - 1].fraction <= hits[j].fraction;
+        }
+        sort(hits.begin(), hits.end(), [](const ray_hit& a, const ray_hit& b) { return a.user_id < b.user_id; });
+        same_hits = same_hits && hits.size() == expected_hits.size();
+        for (size_t j = 0; same_hits && j < hits.size(); j++) {
+            same_hits = hits[j].user_id == expected_hits[j].user_id &&
+                fabs(hits[j].fraction - expected_hits[j].fraction) < 1e-4f;
+        }
+    }
+    check(same_queries, "box queries return the same boxes as brute force");
+    check(same_hits, "segment casts hit the same boxes at the same fractions as brute force");
+    check(ordered, "segment cast hits are sorted by fraction");
+}
+
+int main() {
+    run(1000, 50);
+    run(5000, 20);
+    run(20000, 5);
+    printf("%s\n", failures ? "FAILED" : "ok");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,135 @@
+// Buddy allocator check without GL: blocks are aligned powers of two that never overlap,
+// the size counters add up, and freeing merges buddies back into one block.
+// Build from the repository root:
+//   g++ -O2 -std=c++17 bench/buddy_allocator_check.cpp utils/buddy_allocator.cpp -o buddy_allocator_check
+
+#include "../utils/buddy_allocator.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+using namespace std;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        printf("FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+struct live_block {
+    size_t offset;
+    size_t size;
+    size_t requested;
+};
+
+static void check_known_cases() {
+    BUDDY_ALLOCATOR allocator(1000, 16);
+    check(allocator.get_capacity() == 1024, "capacity is rounded up to a power of two blocks");
+    check(allocator.get_largest_free_block() == 1024, "a new allocator is one free block");
+
+    // 16 rounds up to 16, 17 to 32, both from the start of the range
+    size_t a = allocator.allocate(16);
+    size_t b = allocator.allocate(17);
+    check(a == 0 && allocator.get_block_size(a) == 16, "smallest request gets the minimum block at 0");
+    check(b == 32 && allocator.get_block_size(b) == 32, "a request over the minimum gets the next power of two");
+    check(allocator.get_requested_size() == 33 && allocator.get_allocated_size() == 48, "requested and allocated sizes");
+    check(allocator.get_free_size() == 1024 - 48, "free size is what is not allocated");
+    check(allocator.get_largest_free_block() == 512, "the upper half stays whole");
+
+    check(allocator.allocate(0) == BUDDY_INVALID_OFFSET, "size 0 is rejected");
+    check(allocator.allocate(1025) == BUDDY_INVALID_OFFSET, "more than the capacity is rejected");
+    check(allocator.allocate(1024) == BUDDY_INVALID_OFFSET, "the whole range does not fit while blocks are live");
+
+    allocator.free(a);
+    allocator.free(a);
+    check(allocator.get_allocation_count() == 1 && allocator.get_allocated_size() == 32, "a double free is ignored");
+    allocator.free(b);
+    check(allocator.get_allocation_count() == 0 && allocator.get_free_size() == 1024, "everything freed");
+    check(allocator.get_largest_free_block() == 1024, "freed buddies merge back into one block");
+    check(allocator.allocate(1024) == 0, "after merging the whole range fits again");
+}
+
+// Every second minimum block stays live, the free space is all there but in the smallest pieces
+static void check_fragmentation() {
+    BUDDY_ALLOCATOR allocator(256, 16);
+    vector<size_t> offsets;
+    for (int i = 0; i < 16; i++) {
+        offsets.push_back(allocator.allocate(16));
+    }
+    check(allocator.allocate(16) == BUDDY_INVALID_OFFSET, "a full allocator rejects more");
+    for (int i = 0; i < 16; i += 2) {
+        allocator.free(offsets[i]);
+    }
+    check(allocator.get_free_size() == 128, "half of it is free");
+    check(allocator.get_largest_free_block() == 16, "but only in minimum blocks");
+    check(allocator.allocate(32) == BUDDY_INVALID_OFFSET, "so a bigger block does not fit");
+    for (int i = 1; i < 16; i += 2) {
+        allocator.free(offsets[i]);
+    }
+    check(allocator.get_largest_free_block() == 256, "freeing the rest merges all the way up");
+}
+
+// Random allocations and frees, checked against a list of the live blocks
+static void check_random() {
+    const size_t capacity = 1 << 16;
+    BUDDY_ALLOCATOR allocator(capacity, 64);
+    vector<live_block> live;
+    srand(11);
+    bool aligned = true;
+    bool separate = true;
+    bool counted = true;
+    unsigned int failed = 0;
+    for (int i = 0; i < 20000; i++) {
+        if (live.empty() || rand() % 2 == 0) {
+            size_t size = 1 + rand() % 3000;
+            size_t offset = allocator.allocate(size);
+            if (offset == BUDDY_INVALID_OFFSET) {
+                failed++;
+                continue;
+            }
+            live_block block = {offset, allocator.get_block_size(offset), size};
+            aligned = aligned && block.size >= size && (block.size & (block.size - 1)) == 0 &&
+                offset % block.size == 0 && offset + block.size <= capacity;
+            for (const live_block& other : live) {
+                separate = separate && (offset + block.size <= other.offset || other.offset + other.size <= offset);
+            }
+            live.push_back(block);
+        } else {
+            size_t index = rand() % live.size();
+            allocator.free(live[index].offset);
+            live[index] = live.back();
+            live.pop_back();
+        }
+
+        size_t requested = 0;
+        size_t allocated = 0;
+        for (const live_block& block : live) {
+            requested += block.requested;
+            allocated += block.size;
+        }
+        counted = counted && allocator.get_allocation_count() == live.size() &&
+            allocator.get_requested_size() == requested && allocator.get_allocated_size() == allocated;
+    }
+    printf("random: %zu live blocks, %u failed allocations, %zu of %zu free, largest free block %zu\n",
+        live.size(), failed, allocator.get_free_size(), capacity, allocator.get_largest_free_block());
+    check(aligned, "blocks are powers of two aligned to their size and inside the capacity");
+    check(separate, "live blocks do not overlap");
+    check(counted, "allocation count, requested and allocated sizes match the live blocks");
+
+    for (const live_block& block : live) {
+        allocator.free(block.offset);
+    }
+    check(allocator.get_free_size() == capacity && allocator.get_largest_free_block() == capacity,
+        "freeing everything leaves one block of the whole capacity");
+}
+
+int main() {
+    check_known_cases();
+    check_fragmentation();
+    check_random();
+    printf("%s\n", failures ? "FAILED" : "ok");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,106 @@
+// Late latch check without a window: glfwGetTime, glfwSwapInterval and the event calls
+// are defined here, a 60 Hz display is simulated by a swap that blocks until the next vblank.
+// With 4 ms of work every frame has to make the next vblank, so presents stay 16.7 ms apart.
+// The target fps is set to 40 first, late latch has to keep following the refresh rate anyway.
+// Then target fps mode with a swap that does not block has to present 25 ms apart.
+// Needs the GLFW headers, but not the library. Build from the repository root:
+//   g++ -O2 -std=c++17 bench/frame_pacer_check.cpp utils/frame_pacer.cpp -o frame_pacer_check
+
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+#include "../utils/frame_pacer.hpp"
+
+#include <stdio.h>
+#include <chrono>
+#include <cmath>
+#include <thread>
+using namespace std;
+
+static const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+double glfwGetTime(void) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void glfwSwapInterval(int /* interval */) {
+}
+
+// No events, the wait runs the whole timeout
+void glfwWaitEventsTimeout(double timeout) {
+    this_thread::sleep_for(chrono::duration<double>(timeout));
+}
+
+void glfwPollEvents(void) {
+}
+
+static const double REFRESH_PERIOD = 1.0 / 60.0;
+static const double WORK_TIME = 0.004;
+static const double TARGET_PERIOD = 1.0 / 40.0;
+
+static void spin_for(double seconds) {
+    double end = glfwGetTime() + seconds;
+    while (glfwGetTime() < end) {
+    }
+}
+
+// Blocks until the vblank after now, like a swap with interval 1
+static void swap_buffers() {
+    double now = glfwGetTime();
+    double vblank = (floor(now / REFRESH_PERIOD) + 1.0) * REFRESH_PERIOD;
+    this_thread::sleep_until(start + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(vblank)));
+}
+
+static bool check_late_latch() {
+    FRAME_PACER frame_pacer(PACING_LATE_LATCH, 1.0 / REFRESH_PERIOD);
+    frame_pacer.set_target_fps(1.0 / TARGET_PERIOD);
+    int missed = 0;
+    double last_present = 0.0;
+
+    for (int frame = 0; frame < 180; frame++) {
+        frame_pacer.wait_for_frame();
+        spin_for(WORK_TIME);
+        frame_pacer.frame_submitted();
+        swap_buffers();
+        frame_pacer.frame_presented();
+
+        // The first frames are still finding the work time
+        double now = glfwGetTime();
+        if (frame >= 30 && now - last_present > REFRESH_PERIOD * 1.5) {
+            missed++;
+        }
+        last_present = now;
+    }
+
+    double average = frame_pacer.get_average_frame_time();
+    printf("late latch: average present interval %.2f ms (refresh %.2f ms), jitter %.2f ms, %d missed vblanks\n",
+        average * 1000.0, REFRESH_PERIOD * 1000.0, frame_pacer.get_jitter() * 1000.0, missed);
+
+    // A few misses can come from the OS scheduler, every other frame means the estimate grew into the wait
+    return fabs(average - REFRESH_PERIOD) < REFRESH_PERIOD * 0.1 && missed < 10 &&
+        fabs(frame_pacer.get_frame_period() - REFRESH_PERIOD) < 1e-9;
+}
+
+// Swap interval 0, the swap returns right away and the pacer alone sets the rate
+static bool check_target_fps() {
+    FRAME_PACER frame_pacer(PACING_TARGET_FPS, 1.0 / REFRESH_PERIOD);
+    frame_pacer.set_target_fps(1.0 / TARGET_PERIOD);
+    for (int frame = 0; frame < 60; frame++) {
+        frame_pacer.wait_for_frame();
+        spin_for(WORK_TIME);
+        frame_pacer.frame_submitted();
+        frame_pacer.frame_presented();
+    }
+
+    double average = frame_pacer.get_average_frame_time();
+    printf("target fps: average present interval %.2f ms (target %.2f ms), jitter %.2f ms\n",
+        average * 1000.0, TARGET_PERIOD * 1000.0, frame_pacer.get_jitter() * 1000.0);
+    return fabs(average - TARGET_PERIOD) < TARGET_PERIOD * 0.1 && fabs(frame_pacer.get_frame_period() - TARGET_PERIOD) < 1e-9;
+}
+
+int main() {
+    bool ok = check_late_latch();
+    ok = check_target_fps() && ok;
+    printf("%s\n", ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
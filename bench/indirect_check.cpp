@@ -0,0 +1,57 @@
+// Indirect command builder check without a GL context: one command per listed mesh
+// with its range, one instance each, and the base instance equal to the position in the list.
+// Build from the repository root:
+//   g++ -O2 -std=c++17 bench/indirect_check.cpp render/indirect.cpp -o indirect_check
+
+#include "../render/indirect.hpp"
+
+#include <stdio.h>
+#include <vector>
+using namespace std;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        printf("FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+int main() {
+    static_assert(sizeof(draw_elements_indirect_command) == 20, "DrawElementsIndirectCommand is 5 uints");
+
+    vector<mesh_range> meshes;
+    for (unsigned int i = 0; i < 10; i++) {
+        mesh_range mesh = {i * 100, 3 + i * 3, (int)(i * 50)};
+        meshes.push_back(mesh);
+    }
+
+    // A culled subset, out of order and with a repeat
+    vector<unsigned int> draw_list = {7, 2, 9, 2, 0};
+    vector<draw_elements_indirect_command> commands;
+    build_indirect_commands(meshes, draw_list, commands);
+
+    check(commands.size() == draw_list.size(), "one command per listed mesh");
+    bool ranges = true;
+    bool instances = true;
+    for (size_t i = 0; i < commands.size() && i < draw_list.size(); i++) {
+        const mesh_range& mesh = meshes[draw_list[i]];
+        ranges = ranges && commands[i].count == mesh.index_count && commands[i].first_index == mesh.first_index &&
+            commands[i].base_vertex == mesh.base_vertex;
+        instances = instances && commands[i].instance_count == 1 && commands[i].base_instance == i;
+    }
+    check(ranges, "commands copy the index range and base vertex of their mesh");
+    check(instances, "one instance each, base instance is the position in the draw list");
+
+    // Reused output is resized, not appended to
+    vector<unsigned int> shorter = {4};
+    build_indirect_commands(meshes, shorter, commands);
+    check(commands.size() == 1 && commands[0].first_index == 400 && commands[0].base_instance == 0,
+        "a shorter list replaces the previous commands");
+    build_indirect_commands(meshes, vector<unsigned int>(), commands);
+    check(commands.empty(), "an empty list gives no commands");
+
+    printf("%s\n", failures ? "FAILED" : "ok");
+    return failures ? 1 : 0;
+}
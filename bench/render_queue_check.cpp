@@ -0,0 +1,127 @@
+// Render queue check without a GL context: key order (layer, then state for opaque
+// and back to front for translucent), radix sort stability and state change counts.
+// Build from the repository root:
+//   g++ -O2 -std=c++17 bench/render_queue_check.cpp render/render_queue.cpp -o render_queue_check
+
+#include "../render/render_queue.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+using namespace std;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        printf("FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+// count holds an id, so the order after sorting can be checked
+static draw_packet make_packet(render_layer layer, unsigned int program, unsigned int vao, float depth,
+    bool translucent, unsigned int id) {
+        draw_packet packet = {};
+        packet.key = make_sort_key(layer, program, vao, depth, translucent);
+        packet.program = program;
+        packet.vao = vao;
+        packet.blend = translucent;
+        packet.count = id;
+        return packet;
+}
+
+static void check_key_order() {
+    RENDER_QUEUE queue;
+    RENDER_LIST list;
+    // Recorded in the wrong order on purpose
+    list.add(make_packet(RENDER_LAYER_OVERLAY, 1, 1, 0.5f, true, 0));
+    list.add(make_packet(RENDER_LAYER_SPRITES, 5, 3, 0.2f, true, 1));
+    list.add(make_packet(RENDER_LAYER_SPRITES, 4, 3, 0.9f, true, 2));
+    list.add(make_packet(RENDER_LAYER_WORLD, 2, 1, 0.1f, false, 3));
+    list.add(make_packet(RENDER_LAYER_WORLD, 1, 2, 0.1f, false, 4));
+    list.add(make_packet(RENDER_LAYER_WORLD, 1, 1, 0.8f, false, 5));
+    list.add(make_packet(RENDER_LAYER_WORLD, 1, 1, 0.3f, false, 6));
+    queue.submit_list(list);
+    queue.sort();
+
+    // World by program, vao, then near to far. Sprites far to near, whatever their program. Overlay last
+    unsigned int expected[7] = {6, 5, 4, 3, 2, 1, 0};
+    const vector<draw_packet>& packets = queue.get_packets();
+    bool in_order = packets.size() == 7;
+    for (size_t i = 0; in_order && i < packets.size(); i++) {
+        in_order = packets[i].count == expected[i];
+    }
+    check(in_order, "packets sort by layer, state for opaque and back to front for translucent");
+    check(list.packets.empty(), "submit_list empties the list");
+}
+
+static void check_stable_sort() {
+    // Few distinct keys with many packets each, equal keys have to keep the order they were added in
+    vector<draw_packet> packets;
+    vector<draw_packet> scratch;
+    srand(3);
+    for (unsigned int i = 0; i < 10000; i++) {
+        render_layer layer = (render_layer)(rand() % 3);
+        packets.push_back(make_packet(layer, rand() % 4, rand() % 4, (rand() % 4) / 4.0f, layer != RENDER_LAYER_WORLD, i));
+    }
+    radix_sort_packets(packets, scratch);
+
+    bool sorted = true;
+    bool stable = true;
+    for (size_t i = 1; i < packets.size(); i++) {
+        sorted = sorted && packets[i - 1].key <= packets[i].key;
+        if (packets[i - 1].key == packets[i].key) {
+            stable = stable && packets[i - 1].count < packets[i].count;
+        }
+    }
+    check(sorted, "radix sort orders the keys");
+    check(stable, "radix sort keeps the order of equal keys");
+
+    // A single key skips every pass, the packets must come back untouched
+    vector<draw_packet> same;
+    for (unsigned int i = 0; i < 100; i++) {
+        same.push_back(make_packet(RENDER_LAYER_WORLD, 1, 1, 0.5f, false, i));
+    }
+    radix_sort_packets(same, scratch);
+    bool untouched = true;
+    for (unsigned int i = 0; i < same.size(); i++) {
+        untouched = untouched && same[i].count == i;
+    }
+    check(untouched, "radix sort leaves packets with one key in place");
+}
+
+static void check_state_changes() {
+    RENDER_QUEUE queue;
+    RENDER_LIST list;
+    list.add(make_packet(RENDER_LAYER_WORLD, 1, 1, 0.1f, false, 0));
+    list.add(make_packet(RENDER_LAYER_WORLD, 1, 1, 0.2f, false, 1));
+    list.add(make_packet(RENDER_LAYER_WORLD, 1, 2, 0.1f, false, 2));
+    list.add(make_packet(RENDER_LAYER_WORLD, 2, 1, 0.1f, false, 3));
+    draw_packet sprites = make_packet(RENDER_LAYER_SPRITES, 3, 3, 0.5f, true, 4);
+    sprites.texture = 7;
+    list.add(sprites);
+    queue.submit_list(list);
+    queue.sort();
+
+    // The first packet binds everything, after that only what differs from the packet before
+    render_queue_stats stats = queue.count_state_changes();
+    check(stats.packets == 5, "5 packets counted");
+    check(stats.program_changes == 3, "3 program changes");
+    check(stats.vao_changes == 4, "4 vao changes");
+    check(stats.texture_changes == 2, "2 texture changes");
+    check(stats.blend_changes == 2, "2 blend changes");
+    check(stats.indirect_buffer_changes == 1, "1 indirect buffer change");
+
+    check(get_state_changes(NULL, sprites) == (RENDER_CHANGE_PROGRAM | RENDER_CHANGE_VAO | RENDER_CHANGE_TEXTURE |
+        RENDER_CHANGE_BLEND | RENDER_CHANGE_INDIRECT_BUFFER), "the first packet changes all state");
+    check(get_state_changes(&sprites, sprites) == 0, "the same packet twice changes nothing");
+}
+
+int main() {
+    check_key_order();
+    check_stable_sort();
+    check_state_changes();
+    printf("%s\n", failures ? "FAILED" : "ok");
+    return failures ? 1 : 0;
+}
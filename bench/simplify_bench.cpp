@@ -0,0 +1,74 @@
+// Polygon LOD benchmark, builds the levels of a noisy star outline and checks that
+// none of them crosses itself. Reports vertices, triangles and error per level.
+// Build from the repository root:
+//   g++ -O2 -std=c++17 bench/simplify_bench.cpp shapes/simplify.cpp shapes/mesh.cpp shapes/triangulate.cpp shapes/monotone.cpp utils/predicates.cpp utils/spatial_grid.cpp -o simplify_bench
+
+#include "../shapes/simplify.hpp"
+#include "../shapes/triangulate.hpp"
+#include "../utils/predicates.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <cmath>
+#include <vector>
+using namespace std;
+
+// Star with a few large spikes and a lot of small noise along the outline
+static vector<float> make_noisy_star(int n_vertices) {
+    vector<float> vertices;
+    srand(7);
+    for (int i = 0; i < n_vertices; i++) {
+        double angle = 2.0 * M_PI * i / n_vertices;
+        double radius = 1.0 + 0.3 * sin(angle * 7.0) + 0.01 * (rand() / (double)RAND_MAX);
+        vertices.push_back(radius * cos(angle));
+        vertices.push_back(radius * sin(angle));
+        vertices.push_back(0.0f);
+    }
+    return vertices;
+}
+
+static bool segments_cross(const float* a, const float* b, const float* c, const float* d) {
+    double o1 = orient2d(a[0], a[1], b[0], b[1], c[0], c[1]);
+    double o2 = orient2d(a[0], a[1], b[0], b[1], d[0], d[1]);
+    double o3 = orient2d(c[0], c[1], d[0], d[1], a[0], a[1]);
+    double o4 = orient2d(c[0], c[1], d[0], d[1], b[0], b[1]);
+    return ((o1 > 0 && o2 < 0) || (o1 < 0 && o2 > 0)) && ((o3 > 0 && o4 < 0) || (o3 < 0 && o4 > 0));
+}
+
+static bool is_simple(const vector<float>& vertices) {
+    int n = vertices.size() / 3;
+    for (int i = 0; i < n; i++) {
+        for (int j = i + 2; j < n; j++) {
+            if (i == 0 && j == n - 1) {
+                continue;
+            }
+            if (segments_cross(&vertices[i * 3], &vertices[(i + 1) * 3], &vertices[j * 3], &vertices[((j + 1) % n) * 3])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main() {
+    vector<float> star = make_noisy_star(20000);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    vector<polygon_lod> lods = build_polygon_lods(star.data(), star.size() / 3, 6, 0.25f, 8);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    printf("built %zu levels in %.1f ms\n", lods.size(), seconds * 1000.0);
+
+    bool ok = true;
+    for (size_t i = 0; i < lods.size(); i++) {
+        int n = lods[i].vertices.size() / 3;
+        vector<unsigned int> indices;
+        bool triangulated = triangulate_polygon(lods[i].vertices.data(), &n, 1, TRIANGULATE_MONOTONE, indices);
+        // Level 0 is the input itself
+        bool simple = i == 0 || is_simple(lods[i].vertices);
+        printf("level %zu: %6i vertices %6zu triangles error %.5f %s\n",
+            i, n, indices.size() / 3, lods[i].error, simple && triangulated ? "" : "BROKEN");
+        ok = ok && simple && triangulated;
+    }
+    return ok ? 0 : 1;
+}
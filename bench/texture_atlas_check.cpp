@@ -0,0 +1,151 @@
+// Atlas check on the CPU: packer placements stay in bounds and never overlap, atlas slots
+// are aligned with their padding filled from the sprite edges, and get_uv matches the rects.
+// Build from the repository root:
+//   g++ -O2 -std=c++17 bench/texture_atlas_check.cpp utils/texture_atlas.cpp utils/rect_packer.cpp utils/image.cpp -o texture_atlas_check
+
+#include "../utils/rect_packer.hpp"
+#include "../utils/texture_atlas.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+#include <vector>
+using namespace std;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        printf("FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+static bool overlaps(const packed_rect& a, const packed_rect& b) {
+    return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+static void check_packer() {
+    RECT_PACKER packer(256, 256);
+    vector<packed_rect> rects;
+    srand(5);
+    // Keep going well past full, failed packs must not disturb the ones that fit
+    for (int i = 0; i < 1000; i++) {
+        packed_rect rect;
+        if (packer.pack(1 + rand() % 40, 1 + rand() % 40, rect)) {
+            rects.push_back(rect);
+        }
+    }
+
+    bool in_bounds = true;
+    bool separate = true;
+    for (size_t i = 0; i < rects.size(); i++) {
+        const packed_rect& rect = rects[i];
+        in_bounds = in_bounds && rect.x >= 0 && rect.y >= 0 && rect.x + rect.width <= 256 && rect.y + rect.height <= 256;
+        for (size_t j = 0; j < i; j++) {
+            separate = separate && !overlaps(rect, rects[j]);
+        }
+    }
+    printf("packer: %zu rects, %.0f%% occupied\n", rects.size(), packer.get_occupancy() * 100.0f);
+    check(!rects.empty(), "packer places rects");
+    check(in_bounds, "packed rects stay inside the packer");
+    check(separate, "packed rects do not overlap");
+
+    packed_rect rect;
+    check(!packer.pack(257, 1, rect), "a rect wider than the packer does not fit");
+    packer.reset();
+    check(packer.pack(256, 256, rect) && rect.x == 0 && rect.y == 0, "after reset the whole area is free");
+}
+
+// Every pixel encodes its own position, so copied pixels can be traced back
+static image make_coded_image(int width, int height, unsigned char id) {
+    image result = make_image(width, height, 0, 0, id, 255);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            result.pixels[(y * width + x) * 4] = x;
+            result.pixels[(y * width + x) * 4 + 1] = y;
+        }
+    }
+    return result;
+}
+
+static const unsigned char* get_pixel(const image& page, int x, int y) {
+    return &page.pixels[((size_t)y * page.width + x) * 4];
+}
+
+static void check_atlas() {
+    const int mip_levels = 2;
+    const int alignment = 1 << mip_levels;
+    TEXTURE_ATLAS atlas(256, 256, mip_levels);
+    vector<image> sources;
+    srand(9);
+    for (int i = 0; i < 40; i++) {
+        sources.push_back(make_coded_image(1 + rand() % 20, 1 + rand() % 20, i));
+        check(atlas.add_image(sources.back()) == i, "sprite ids count up from 0");
+    }
+    const image& page = atlas.get_page();
+
+    bool aligned = true;
+    bool separate = true;
+    bool contents = true;
+    bool padded = true;
+    bool uvs = true;
+    for (int i = 0; i < atlas.get_sprite_count(); i++) {
+        packed_rect rect = atlas.get_rect(i);
+        const image& source = sources[i];
+
+        // The slot starts a padding before the sprite and is a whole number of aligned blocks
+        packed_rect slot = {rect.x - alignment, rect.y - alignment, rect.width + 2 * alignment, rect.height + 2 * alignment};
+        aligned = aligned && slot.x % alignment == 0 && slot.y % alignment == 0 && slot.x >= 0 && slot.y >= 0 &&
+            slot.x + slot.width <= page.width && slot.y + slot.height <= page.height;
+        for (int j = 0; j < i; j++) {
+            packed_rect other = atlas.get_rect(j);
+            packed_rect other_slot = {other.x - alignment, other.y - alignment, other.width + 2 * alignment, other.height + 2 * alignment};
+            separate = separate && !overlaps(slot, other_slot);
+        }
+
+        // Inside the rect the image itself, in the padding the nearest edge pixel
+        for (int y = slot.y; y < slot.y + slot.height; y++) {
+            for (int x = slot.x; x < slot.x + slot.width; x++) {
+                int source_x = min(max(x - rect.x, 0), source.width - 1);
+                int source_y = min(max(y - rect.y, 0), source.height - 1);
+                bool same = memcmp(get_pixel(page, x, y), &source.pixels[(source_y * source.width + source_x) * 4], 4) == 0;
+                bool inside = x >= rect.x && x < rect.x + rect.width && y >= rect.y && y < rect.y + rect.height;
+                if (inside) {
+                    contents = contents && same;
+                } else {
+                    padded = padded && same;
+                }
+            }
+        }
+
+        atlas_uv uv = atlas.get_uv(i);
+        uvs = uvs && fabs(uv.u0 - (float)rect.x / page.width) < 1e-6f && fabs(uv.v0 - (float)rect.y / page.height) < 1e-6f &&
+            fabs(uv.u1 - (float)(rect.x + rect.width) / page.width) < 1e-6f &&
+            fabs(uv.v1 - (float)(rect.y + rect.height) / page.height) < 1e-6f;
+    }
+    check(aligned, "slots are aligned to 2^mip_levels and inside the page");
+    check(separate, "slots do not overlap");
+    check(contents, "sprites are copied into their rects");
+    check(padded, "padding repeats the sprite edges");
+    check(uvs, "get_uv matches the sprite rects");
+
+    // Known case: the first sprite goes to the top left corner, right after the padding
+    atlas_uv first = atlas.get_uv(0);
+    packed_rect first_rect = atlas.get_rect(0);
+    check(first_rect.x == alignment && first_rect.y == alignment, "first sprite sits one padding from the corner");
+    check(first.u0 == alignment / 256.0f && first.v0 == alignment / 256.0f, "first sprite uv starts after the padding");
+
+    check(atlas.is_dirty(), "adding images marks the atlas dirty");
+    atlas.clear_dirty();
+    check(!atlas.is_dirty(), "clear_dirty clears it");
+    check(atlas.add_image(make_coded_image(300, 1, 0)) == -1, "an image wider than the page is rejected");
+}
+
+int main() {
+    check_packer();
+    check_atlas();
+    printf("%s\n", failures ? "FAILED" : "ok");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,126 @@
+// Triangulation benchmark, ear clipping against the monotone sweep on inputs that
+// are bad for ear clipping (spirals and combs), plus a polygon with holes.
+// Build from the repository root:
+//   g++ -O2 -std=c++17 bench/triangulate_bench.cpp shapes/triangulate.cpp shapes/monotone.cpp utils/predicates.cpp -o triangulate_bench
+
+#include "../shapes/triangulate.hpp"
+
+#include <stdio.h>
+#include <chrono>
+#include <cmath>
+#include <vector>
+using namespace std;
+
+static void add_vertex(vector<float>& vertices, double x, double y) {
+    vertices.push_back(x);
+    vertices.push_back(y);
+    vertices.push_back(0.0f);
+}
+
+// A thick spiral strip, out along one side and back along the other
+static vector<float> make_spiral(int n_vertices) {
+    int half = n_vertices / 2;
+    vector<float> vertices;
+    for (int i = 0; i < half; i++) {
+        double angle = i * 0.05;
+        double radius = 1.0 + angle * 0.5;
+        add_vertex(vertices, radius * cos(angle), radius * sin(angle));
+    }
+    for (int i = half - 1; i >= 0; i--) {
+        double angle = i * 0.05;
+        double radius = 1.2 + angle * 0.5;
+        add_vertex(vertices, radius * cos(angle), radius * sin(angle));
+    }
+    return vertices;
+}
+
+// Long thin teeth hanging down from a bar
+static vector<float> make_comb(int n_vertices) {
+    int n_teeth = (n_vertices - 2) / 4;
+    vector<float> vertices;
+    add_vertex(vertices, 0.0, 10.0);
+    for (int i = 0; i < n_teeth; i++) {
+        add_vertex(vertices, i * 1.0, 0.0);
+        add_vertex(vertices, i * 1.0 + 0.5, 0.0);
+        add_vertex(vertices, i * 1.0 + 0.5, 9.0);
+        add_vertex(vertices, i * 1.0 + 1.0, 9.0);
+    }
+    add_vertex(vertices, n_teeth * 1.0, 10.0);
+    return vertices;
+}
+
+static double polygon_area(const float vertices[], int n) {
+    double area = 0.0;
+    for (int i = 0; i < n; i++) {
+        int j = (i + 1) % n;
+        area += (double)vertices[3 * i] * vertices[3 * j + 1] - (double)vertices[3 * j] * vertices[3 * i + 1];
+    }
+    return fabs(area) / 2.0;
+}
+
+static double triangles_area(const vector<float>& vertices, const vector<unsigned int>& indices) {
+    double area = 0.0;
+    for (size_t t = 0; t < indices.size(); t += 3) {
+        const float* a = &vertices[3 * indices[t]];
+        const float* b = &vertices[3 * indices[t + 1]];
+        const float* c = &vertices[3 * indices[t + 2]];
+        area += fabs((double)(b[0] - a[0]) * (c[1] - a[1]) - (double)(b[1] - a[1]) * (c[0] - a[0])) / 2.0;
+    }
+    return area;
+}
+
+static bool run(const char* name, const vector<float>& vertices, const vector<int>& contours,
+                triangulation_engine engine, double expected_area) {
+    vector<unsigned int> indices;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    bool ok = triangulate_polygon(vertices.data(), contours.data(), contours.size(), engine, indices);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    int n_vertices = vertices.size() / 3;
+    size_t expected_triangles = n_vertices - 2 + 2 * (contours.size() - 1);
+    double area = triangles_area(vertices, indices);
+    bool valid = ok && indices.size() / 3 == expected_triangles && fabs(area - expected_area) < 1e-3 * expected_area;
+    printf("%-8s %6d vertices %-13s %10.3f ms  %s\n", name, n_vertices,
+        engine == TRIANGULATE_MONOTONE ? "monotone" : "ear clipping", ms, valid ? "ok" : "FAILED");
+    return valid;
+}
+
+int main() {
+    bool all_valid = true;
+    int sizes[] = {1000, 4000, 16000};
+    for (int n : sizes) {
+        vector<float> spiral = make_spiral(n);
+        vector<int> spiral_contour = {(int)spiral.size() / 3};
+        double spiral_area = polygon_area(spiral.data(), spiral.size() / 3);
+        all_valid &= run("spiral", spiral, spiral_contour, TRIANGULATE_EAR_CLIPPING, spiral_area);
+        all_valid &= run("spiral", spiral, spiral_contour, TRIANGULATE_MONOTONE, spiral_area);
+
+        vector<float> comb = make_comb(n);
+        vector<int> comb_contour = {(int)comb.size() / 3};
+        double comb_area = polygon_area(comb.data(), comb.size() / 3);
+        all_valid &= run("comb", comb, comb_contour, TRIANGULATE_EAR_CLIPPING, comb_area);
+        all_valid &= run("comb", comb, comb_contour, TRIANGULATE_MONOTONE, comb_area);
+    }
+
+    // Square with a grid of square holes, only the monotone engine supports these
+    int grid = 30;
+    vector<float> holes;
+    vector<int> contours;
+    add_vertex(holes, 0.0, 0.0);
+    add_vertex(holes, grid, 0.0);
+    add_vertex(holes, grid, grid);
+    add_vertex(holes, 0.0, grid);
+    contours.push_back(4);
+    for (int y = 0; y < grid; y++) {
+        for (int x = 0; x < grid; x++) {
+            add_vertex(holes, x + 0.25, y + 0.25);
+            add_vertex(holes, x + 0.75, y + 0.25);
+            add_vertex(holes, x + 0.75, y + 0.75);
+            add_vertex(holes, x + 0.25, y + 0.75);
+            contours.push_back(4);
+        }
+    }
+    all_valid &= run("holes", holes, contours, TRIANGULATE_MONOTONE, grid * grid * 0.75);
+
+    return all_valid ? 0 : 1;
+}
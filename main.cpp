@@ -8,6 +8,24 @@
 #include "shapes/triangle.hpp"
 #include "shapes/quad.hpp"
 #include "shapes/circle.hpp"
+#include "shapes/mesh.hpp"
+#include "render/mesh_pool.hpp"
+#include "render/gl_handles.hpp"
+#include "render/gpu_heap.hpp"
+#include "render/sprite_batch.hpp"
+#include "render/text_renderer.hpp"
+#include "render/render_queue.hpp"
+#include "render/render_submit.hpp"
+#include "render/render_target.hpp"
+#include "render/gpu_timer.hpp"
+#include "render/shader_cache.hpp"
+#include "utils/spatial_grid.hpp"
+#include "utils/job_system.hpp"
+#include "utils/input.hpp"
+#include "utils/frame_pacer.hpp"
+#include "utils/texture_atlas.hpp"
+#include "utils/resolution_scaler.hpp"
+#include "render/stream_loader.hpp"
 
 #include <stdio.h>
 #include <iostream>
@@ -17,13 +35,13 @@
 #include <assert.h>
 using namespace std;
 
-// For fps control
-#include <unistd.h>
-
 
 // Constants
 int window_width = 800;
 int window_height = 800;
+// In pixels, differs from the window size on high dpi screens
+int framebuffer_width = 800;
+int framebuffer_height = 800;
 
 const char* title = "Hello World!";
 
@@ -31,12 +49,17 @@ void glfw_error_callback(int error, const char* description) {
   gl_log("GLFW ERROR: code %i msg: %s\n", error, description);
 }
 
-void glfw_window_size_callback(GLFWwindow* window, int width, int height) {
+void glfw_window_size_callback(GLFWwindow* /* window */, int width, int height) {
     window_width = width;
     window_height = height;
 }
 
-void _update_fps_counter(GLFWwindow* window) {
+void glfw_framebuffer_size_callback(GLFWwindow* /* window */, int width, int height) {
+    framebuffer_width = width;
+    framebuffer_height = height;
+}
+
+void _update_fps_counter(FRAME_PACER& frame_pacer, float render_scale, char* text, size_t text_size) {
     static double previous_seconds = glfwGetTime();
     static int frame_count;
     double current_seconds = glfwGetTime();
@@ -44,67 +67,99 @@ void _update_fps_counter(GLFWwindow* window) {
     if (elapsed_seconds > 0.25) {
         previous_seconds = current_seconds;
         double fps = (double)frame_count / elapsed_seconds;
-        char tmp[128];
-        sprintf(tmp, "opengl @ fps: %.2f", fps);
-
-        // For now use the window title to display the frame rate
-        glfwSetWindowTitle(window, tmp);
+        snprintf(text, text_size, "fps: %.2f\njitter: %.2f ms\npacing: %s\nscale: %.3f",
+            fps, frame_pacer.get_jitter() * 1000.0, frame_pacer.get_mode_name(), render_scale);
         frame_count = 0;
     }
     frame_count++;
 }
 
-int main() {
-    assert(restart_gl_log());
-    gl_log("starting GLFW\n%s\n", glfwGetVersionString());
-
-    // Init a callback function for GLFW internal errors
-    glfwSetErrorCallback(glfw_error_callback);
-    if (!glfwInit()) {
-        cout << "GLFW initialization failed" << endl;
-        glfwTerminate();
-        return 1;
-    }
-
-    // For apple machines
-#ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-#endif
-
-    // Init a GLFW window
-    GLFWwindow *window = glfwCreateWindow(window_width, window_height, title, NULL, NULL);
-    if (!window) {
-        cout << "Window Creation failed" << endl;
-        glfwDestroyWindow(window);
-        return 1;
+// Shapes only update their own offsets and transform here, so they can move in parallel.
+// The grid is synced afterwards on a single thread.
+void move_shapes(JOB_SYSTEM& job_system, SHAPE shapes[], int n_shapes, INPUT_STATE& input_state, float speed, double delta_time) {
+    if (delta_time <= 0.0) {
+        return;
     }
+    bool up = input_state.is_down(GLFW_KEY_UP);
+    bool right = input_state.is_down(GLFW_KEY_RIGHT);
+    bool down = input_state.is_down(GLFW_KEY_DOWN);
+    bool left = input_state.is_down(GLFW_KEY_LEFT);
+    job_system.parallel_for(0, n_shapes, 256, [&](unsigned int first, unsigned int last) {
+        for (unsigned int i = first; i < last; i++) {
+            shapes[i].set_delta_time(delta_time);
+            if (up) {
+                shapes[i].move_up(speed);
+            }
+            if (right) {
+                shapes[i].move_right(speed);
+            }
+            if (down) {
+                shapes[i].move_down(speed);
+            }
+            if (left) {
+                shapes[i].move_left(speed);
+            }
+        }
+    });
+}
 
-    // Create the current context and load glad extension
-    glfwMakeContextCurrent(window);
-
-    // Load glad
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        cout << "Failed to initialize GLAD" << endl;
-        return 0;
+// Static level geometry made by tools/scene_converter, streamed in over the next frames.
+// The level is optional, the repository does not ship one
+void load_level(STREAM_LOADER& stream_loader) {
+    if (ifstream("level.scene").good()) {
+        stream_loader.load_scene("level.scene", 64);
     }
+}
 
-    // Print version info
-    const GLubyte* renderer = glGetString(GL_RENDERER); // get renderer string
-    const GLubyte* version = glGetString(GL_VERSION); // version as a string
-    printf("Renderer: %s\n", renderer);
-    printf("OpenGL version supported %s\n", version);
-
-    // Log openGL paramters after glad is loaded
-    log_gl_params();
+void simulate_step(GLFWwindow* window, double step_start, double step, INPUT_QUEUE& input_queue,
+    INPUT_STATE& input_state, JOB_SYSTEM& job_system, SHAPE shapes[], int n_shapes, float speed,
+    SPATIAL_GRID& spatial_grid, FRAME_PACER& frame_pacer, STREAM_LOADER& stream_loader) {
+        // Split the step at every event, so a press shorter than a step still moves for as long as it was held
+        double segment_start = step_start;
+        double step_end = step_start + step;
+        input_event event;
+        while (input_queue.pop_until(step_end, event)) {
+            if (event.time > segment_start) {
+                move_shapes(job_system, shapes, n_shapes, input_state, speed, event.time - segment_start);
+                segment_start = event.time;
+            }
+            input_state.apply(event);
+
+            if (event.type == INPUT_KEY && event.key == GLFW_KEY_ESCAPE && event.action == GLFW_PRESS) {
+                glfwSetWindowShouldClose(window, 1);
+            }
+            if (event.type == INPUT_KEY && event.key == GLFW_KEY_V && event.action == GLFW_PRESS) {
+                // Cycle vsync, uncapped, target fps and late latch
+                frame_pacer.set_mode((frame_pacing_mode)((frame_pacer.get_mode() + 1) % 4));
+            }
+            if (event.type == INPUT_KEY && event.key == GLFW_KEY_R && event.action == GLFW_PRESS) {
+                // Pick up edited shader files, every variant keeps its program name and features
+                reload_shader_programs();
+            }
+            if (event.type == INPUT_KEY && event.key == GLFW_KEY_L && event.action == GLFW_PRESS) {
+                // Reload the level, the new load takes over the mesh ids and pool space of the old one
+                stream_loader.unload();
+                load_level(stream_loader);
+            }
+            if (event.type == INPUT_MOUSE_BUTTON && event.key == GLFW_MOUSE_BUTTON_LEFT && event.action == GLFW_PRESS) {
+                // Pick whatever is under the cursor, screen coordinates to normalized device coordinates
+                float x = 2.0f * input_state.cursor_x / window_width - 1.0f;
+                float y = 1.0f - 2.0f * input_state.cursor_y / window_height;
+                vector<unsigned int> picked;
+                spatial_grid.query_point(x, y, picked);
+                for (unsigned int id : picked) {
+                    gl_log("picked mesh %u at %.2f %.2f\n", id, x, y);
+                }
+            }
+        }
+        move_shapes(job_system, shapes, n_shapes, input_state, speed, step_end - segment_start);
+}
 
-    // Only draw a pixel when it is positioned closer to the screen (in front of other pixels)
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
+// Everything that owns GL objects lives in here, so it is all released before the context goes away
+void run(GLFWwindow* window, DELETION_QUEUE& deletion_queue) {
+    // Shader variants are compiled on first use and shared, declared first so it outlives their users
+    SHADER_CACHE shader_cache;
+    set_shader_cache(&shader_cache);
 
     // Define traingle points, x, y, z
     float points[] = {
@@ -136,71 +191,253 @@ int main() {
         0.0f, 0.8f, 1.0f,
     };
 
-    //TRIANGLE random_triangle(points, colors);
-    QUAD random_quad(quad_points, quad_colors);
-    //CIRCLE random_circle(0.0f, 0.0f, 1.0f, 36);
+    // Worker threads for geometry, loading and per frame updates, one per spare core
+    JOB_SYSTEM job_system(0);
+
+    // All shapes live in one pool and are drawn with a single indirect call per frame
+    MESH_POOL mesh_pool(1 << 18, 1 << 20, 1 << 14, 2);
+    // Shapes are registered in a grid by mesh id so only the ones in view get drawn
+    SPATIAL_GRID spatial_grid(0.5f);
+    mesh_data meshes[3];
+    SHAPE shapes[3];
+    int mesh_ids[3];
+    int n_shapes = 3;
+
+    // Geometry is built on the workers, the upload waits for all of it on the main thread
+    job_handle upload = job_system.create_main_thread_job([&] {
+        for (int i = 0; i < n_shapes; i++) {
+            mesh_ids[i] = mesh_pool.add_mesh(meshes[i]);
+            shapes[i].set_local_bounds(get_mesh_bounds(meshes[i]));
+            shapes[i].set_spatial_index(&spatial_grid, mesh_ids[i]);
+        }
+    });
+    job_system.add_dependency(upload, job_system.run([&] { meshes[0] = make_triangle_mesh(points, colors); }));
+    job_system.add_dependency(upload, job_system.run([&] { meshes[1] = make_quad_mesh(quad_points, quad_colors); }));
+    job_system.add_dependency(upload, job_system.run([&] { meshes[2] = make_circle_mesh(0.0f, 0.0f, 0.25f, 36); }));
+    job_system.submit(upload);
+    job_system.wait(upload);
+
+    STREAM_LOADER stream_loader(&mesh_pool, &spatial_grid, &job_system);
+    load_level(stream_loader);
+
+    // Without a camera the view is the normalized device coordinate square
+    aabb view = {-1.0f, -1.0f, 1.0f, 1.0f};
+    vector<unsigned int> visible;
     float speed = 1.0f; // Speed in f/s (distance / time)
 
     // Set a background color
     glClearColor(0.8f, 0.8f, 1.0f, 1);
 
-    double previous_time = glfwGetTime();
+    // Sprites share one atlas page and draw in one call, padded for 2 mip levels
+    TEXTURE_ATLAS atlas(512, 512, 2);
+    image checker = make_image(16, 16, 255, 255, 255, 255);
+    for (int y = 0; y < 16; y++) {
+        for (int x = 0; x < 16; x++) {
+            if ((x / 4 + y / 4) % 2) {
+                checker.pixels[(y * 16 + x) * 4 + 1] = 128;
+            }
+        }
+    }
+    int checker_sprite = atlas.add_image(checker);
+    SPRITE_BATCH sprite_batch(1024, 0);
+    sprite_batch.set_atlas(&atlas);
+
+    // Glyph distance fields are built on the first run and read from the cache after that
+    TEXT_RENDERER text_renderer(4096, "glyphs.pam");
+    char stats_text[128] = "";
+
+    // Draws are recorded into lists, sorted by state and submitted once per frame
+    RENDER_QUEUE render_queue;
+    RENDER_LIST world_list;
+    RENDER_LIST overlay_list;
+
+    // Input arrives through callbacks with timestamps and is consumed by a fixed step simulation
+    INPUT_QUEUE input_queue;
+    INPUT_STATE input_state;
+    install_input_callbacks(window, &input_queue);
+    // Picking converts cursor positions with the current window size, rendering uses the framebuffer size
+    glfwSetWindowSizeCallback(window, glfw_window_size_callback);
+    glfwSetFramebufferSizeCallback(window, glfw_framebuffer_size_callback);
+    glfwGetWindowSize(window, &window_width, &window_height);
+    glfwGetFramebufferSize(window, &framebuffer_width, &framebuffer_height);
+    const double simulation_step = 1.0 / 120.0;
+    const int max_simulation_steps = 5;
+
+    // Pace frames to the monitor, late latch keeps vsync but starts each frame just before it is due
+    const GLFWvidmode* video_mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+    FRAME_PACER frame_pacer(PACING_LATE_LATCH, video_mode ? video_mode->refreshRate : 60.0);
+    // Target fps mode holds a steady rate of its own, independent of the monitor
+    const double target_fps = 50.0;
+    frame_pacer.set_target_fps(target_fps);
+    double simulation_time = glfwGetTime();
+
+    // The scene renders offscreen at a scale that keeps its GPU time within 75% of a frame,
+    // then gets stretched over the window. The overlay is drawn after that at full resolution.
+    RENDER_TARGET scene_target(framebuffer_width, framebuffer_height);
+    RESOLUTION_SCALER resolution_scaler(0.5f, 1.0f, 0.75);
+    GPU_TIMER scene_timer;
 
     // game loop
     while(!glfwWindowShouldClose(window)) {
-        // Calculate delta time before handling input events
-        double delta_time = glfwGetTime() - previous_time;
-        //random_triangle.set_delta_time(delta_time);
-        random_quad.set_delta_time(delta_time);
-        //random_circle.set_delta_time(delta_time);
-        previous_time = glfwGetTime();
+        // Wait for the right moment to start the frame, events that arrive meanwhile go into the input queue
+        frame_pacer.wait_for_frame();
 
-        // Update fps
-        _update_fps_counter(window);
+        // Whatever arrived since, during the last frame's work or its swap, is stamped now
+        glfwPollEvents();
 
-        // Clear screen
+        // Catch the simulation up to now, events are applied at the time they happened.
+        // After a long frame the rest is dropped, otherwise catching up makes the next frame longer still
+        double current_time = glfwGetTime();
+        int steps = 0;
+        while (simulation_time + simulation_step <= current_time && steps < max_simulation_steps) {
+            simulate_step(window, simulation_time, simulation_step, input_queue, input_state,
+                job_system, shapes, n_shapes, speed, spatial_grid, frame_pacer, stream_loader);
+            simulation_time += simulation_step;
+            steps++;
+        }
+        if (simulation_time + simulation_step <= current_time) {
+            // Events in the dropped time are still applied by the next step, they just do not move anything
+            simulation_time = current_time;
+        }
+
+        // GL work queued by jobs
+        job_system.run_main_thread_jobs();
+
+        // Upload whatever the loader has ready, 2 ms per frame at most
+        if (!stream_loader.is_done()) {
+            stream_loader.pump(0.002);
+            if (stream_loader.is_done()) {
+                log_gpu_memory_stats();
+            }
+        }
+
+        // Update fps
+        _update_fps_counter(frame_pacer, resolution_scaler.get_scale(), stats_text, sizeof(stats_text));
+
+        // Levels of detail are picked for the resolution the scene renders at this frame
+        float render_scale = resolution_scaler.get_scale();
+        mesh_pool.set_viewport_size(framebuffer_width * render_scale, framebuffer_height * render_scale);
+
+        // The moved shapes are synced into the grid and the pool, then the world is culled
+        // and recorded, all on a worker while this thread records sprites and text
+        job_handle record_world = job_system.run([&] {
+            for (int i = 0; i < n_shapes; i++) {
+                shapes[i].sync_spatial_index();
+                mesh_pool.set_transform(mesh_ids[i], shapes[i].get_transform());
+            }
+            spatial_grid.query_rect(view, visible);
+            mesh_pool.record(world_list, visible);
+            render_queue.submit_list(world_list);
+        });
+
+        sprite_batch.add(checker_sprite, -0.95f, 0.95f, 0.1f, 0.1f);
+        sprite_batch.record(overlay_list, RENDER_LAYER_SPRITES);
+
+        // Stats overlay, drawn over everything else
+        text_renderer.set_viewport(framebuffer_width, framebuffer_height);
+        text_renderer.add_text(stats_text, 10.0f, 10.0f, 2.0f, 0.1f, 0.1f, 0.2f);
+        text_renderer.record(overlay_list);
+        render_queue.submit_list(overlay_list);
+
+        job_system.wait(record_world);
+        sprite_batch.update_texture();
+        render_queue.sort();
+
+        // Follow window resizes, only reallocates when the size really changed
+        scene_target.resize(framebuffer_width, framebuffer_height);
+
+        // Scene pass at the dynamic resolution, sorted to bind as little as possible
+        scene_target.bind(resolution_scaler.get_scale());
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        
-        //random_triangle.draw();
-        random_quad.draw();
-        //random_circle.draw();
+        scene_timer.begin();
+        submit_render_queue(render_queue, RENDER_LAYER_WORLD, RENDER_LAYER_SPRITES);
+        scene_timer.end();
+
+        // Upscale into the window, then the overlay on top at native resolution
+        scene_target.blit_to_screen(framebuffer_width, framebuffer_height);
+        submit_render_queue(render_queue, RENDER_LAYER_OVERLAY, RENDER_LAYER_OVERLAY);
+        render_queue.clear();
+
+        double scene_time;
+        if (scene_timer.get_elapsed(&scene_time)) {
+            resolution_scaler.update(scene_time, frame_pacer.get_frame_period());
+        }
 
         // Put the stuff we've been drawing onto the display
+        frame_pacer.frame_submitted();
         glfwSwapBuffers(window);
+        frame_pacer.frame_presented();
 
-        // Update other events like input handling 
-        glfwPollEvents();
+        // Objects released this frame are deleted once the GPU is done with them
+        deletion_queue.end_frame();
+    }
 
-        if (GLFW_PRESS == glfwGetKey(window, GLFW_KEY_ESCAPE)){
-            glfwSetWindowShouldClose(window, 1);
-        } 
-        if (GLFW_PRESS == glfwGetKey(window, GLFW_KEY_UP)) {
-            //random_triangle.move_up(speed);
-            random_quad.move_up(speed);
-            //random_circle.move_up(speed);
-        } 
-        if (GLFW_PRESS == glfwGetKey(window, GLFW_KEY_RIGHT)) {
-            //random_triangle.move_right(speed);
-            random_quad.move_right(speed);
-            //random_circle.move_right(speed);
-        } 
-        if (GLFW_PRESS == glfwGetKey(window, GLFW_KEY_DOWN)) {
-            //random_triangle.move_down(speed);
-            random_quad.move_down(speed);
-            //random_circle.move_down(speed);
-        } 
-        if (GLFW_PRESS == glfwGetKey(window, GLFW_KEY_LEFT)) {
-            //random_triangle.move_left(speed);
-            random_quad.move_left(speed);
-            //random_circle.move_left(speed);
-        }
+    log_gpu_memory_stats();
+    gl_log("%u shader variants compiled\n", shader_cache.get_variant_count());
+    set_shader_cache(NULL);
+}
+
+int main() {
+    assert(restart_gl_log());
+    gl_log("starting GLFW\n%s\n", glfwGetVersionString());
+
+    // Init a callback function for GLFW internal errors
+    glfwSetErrorCallback(glfw_error_callback);
+    if (!glfwInit()) {
+        cout << "GLFW initialization failed" << endl;
+        glfwTerminate();
+        return 1;
+    }
+
+    // For apple machines, 4.1 core is the newest there is. The shaders need 4.0,
+    // the mesh pool falls back to one draw per mesh without 4.3
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#endif
+
+    // Init a GLFW window
+    GLFWwindow *window = glfwCreateWindow(window_width, window_height, title, NULL, NULL);
+    if (!window) {
+        cout << "Window Creation failed" << endl;
+        glfwDestroyWindow(window);
+        return 1;
+    }
+
+    // Create the current context and load glad extension
+    glfwMakeContextCurrent(window);
+
+    // Load glad
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cout << "Failed to initialize GLAD" << endl;
+        return 0;
     }
 
-    //random_triangle.delete_buffers();
-    random_quad.delete_buffers();
-    //random_circle.delete_buffers();
+    // Print version info
+    const GLubyte* renderer = glGetString(GL_RENDERER); // get renderer string
+    const GLubyte* version = glGetString(GL_VERSION); // version as a string
+    printf("Renderer: %s\n", renderer);
+    printf("OpenGL version supported %s\n", version);
+
+    // Log openGL paramters after glad is loaded
+    log_gl_params();
+
+    // Only draw a pixel when it is positioned closer to the screen (in front of other pixels)
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+
+    // GL objects are deleted in batches at the end of a frame, once the GPU has finished with them
+    DELETION_QUEUE deletion_queue;
+    set_deletion_queue(&deletion_queue);
+
+    run(window, deletion_queue);
 
-    // TODO: Delete shaders aswell
+    // Shaders, buffers and vertex arrays were released when run returned, delete them all now
+    deletion_queue.flush();
+    set_deletion_queue(NULL);
 
     // Destory/Terminate GLFW components
     glfwDestroyWindow(window);
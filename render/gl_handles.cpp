@@ -0,0 +1,144 @@
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+#include "gl_handles.hpp"
+
+static DELETION_QUEUE* deletion_queue = NULL;
+
+DELETION_QUEUE::DELETION_QUEUE() {
+    current.fence = 0;
+}
+
+DELETION_QUEUE::~DELETION_QUEUE() {
+    if (deletion_queue == this) {
+        deletion_queue = NULL;
+    }
+}
+
+void DELETION_QUEUE::enqueue(gpu_object_type type, GLuint name) {
+    current.names[type].push_back(name);
+}
+
+void DELETION_QUEUE::end_frame() {
+    // Everything released this frame may still be used by commands issued this frame
+    bool empty = true;
+    for (int i = 0; i < GPU_OBJECT_TYPES; i++) {
+        empty = empty && current.names[i].empty();
+    }
+    if (!empty) {
+        current.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        waiting.push_back(current);
+        current = deletion_batch();
+        current.fence = 0;
+    }
+
+    // Fences signal in order, stop at the first one the GPU has not reached
+    while (!waiting.empty()) {
+        GLenum status = glClientWaitSync(waiting.front().fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            break;
+        }
+        delete_batch(waiting.front());
+        waiting.pop_front();
+    }
+}
+
+void DELETION_QUEUE::flush() {
+    // Shutdown, wait for the GPU once and delete everything
+    glFinish();
+    while (!waiting.empty()) {
+        delete_batch(waiting.front());
+        waiting.pop_front();
+    }
+    delete_batch(current);
+    current = deletion_batch();
+    current.fence = 0;
+}
+
+unsigned int DELETION_QUEUE::get_pending_count() {
+    unsigned int count = 0;
+    for (int i = 0; i < GPU_OBJECT_TYPES; i++) {
+        count += current.names[i].size();
+        for (deletion_batch& batch : waiting) {
+            count += batch.names[i].size();
+        }
+    }
+    return count;
+}
+
+// One call per type for the whole batch, programs can only be deleted one at a time
+static void delete_objects(gpu_object_type type, GLsizei n, const GLuint* names) {
+    switch (type) {
+        case GPU_OBJECT_BUFFER: glDeleteBuffers(n, names); break;
+        case GPU_OBJECT_VERTEX_ARRAY: glDeleteVertexArrays(n, names); break;
+        case GPU_OBJECT_PROGRAM:
+            for (GLsizei i = 0; i < n; i++) {
+                glDeleteProgram(names[i]);
+            }
+            break;
+        case GPU_OBJECT_TEXTURE: glDeleteTextures(n, names); break;
+        case GPU_OBJECT_FRAMEBUFFER: glDeleteFramebuffers(n, names); break;
+        case GPU_OBJECT_RENDERBUFFER: glDeleteRenderbuffers(n, names); break;
+        case GPU_OBJECT_QUERY: glDeleteQueries(n, names); break;
+        default: break;
+    }
+}
+
+void DELETION_QUEUE::delete_batch(deletion_batch& batch) {
+    for (int i = 0; i < GPU_OBJECT_TYPES; i++) {
+        if (!batch.names[i].empty()) {
+            delete_objects((gpu_object_type)i, batch.names[i].size(), batch.names[i].data());
+        }
+    }
+    if (batch.fence) {
+        glDeleteSync(batch.fence);
+    }
+}
+
+void set_deletion_queue(DELETION_QUEUE* queue) {
+    deletion_queue = queue;
+}
+
+void release_gpu_object(gpu_object_type type, GLuint name) {
+    if (deletion_queue) {
+        deletion_queue->enqueue(type, name);
+        return;
+    }
+    delete_objects(type, 1, &name);
+}
+
+GPU_BUFFER create_buffer() {
+    GLuint name = 0;
+    glGenBuffers(1, &name);
+    return GPU_BUFFER(name);
+}
+
+GPU_VERTEX_ARRAY create_vertex_array() {
+    GLuint name = 0;
+    glGenVertexArrays(1, &name);
+    return GPU_VERTEX_ARRAY(name);
+}
+
+GPU_TEXTURE create_texture() {
+    GLuint name = 0;
+    glGenTextures(1, &name);
+    return GPU_TEXTURE(name);
+}
+
+GPU_FRAMEBUFFER create_framebuffer() {
+    GLuint name = 0;
+    glGenFramebuffers(1, &name);
+    return GPU_FRAMEBUFFER(name);
+}
+
+GPU_RENDERBUFFER create_renderbuffer() {
+    GLuint name = 0;
+    glGenRenderbuffers(1, &name);
+    return GPU_RENDERBUFFER(name);
+}
+
+GPU_QUERY create_query() {
+    GLuint name = 0;
+    glGenQueries(1, &name);
+    return GPU_QUERY(name);
+}
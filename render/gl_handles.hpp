@@ -0,0 +1,105 @@
+#ifndef GL_HANDLES_H
+#define GL_HANDLES_H
+
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+#include <deque>
+#include <vector>
+using namespace std;
+
+enum gpu_object_type {
+    GPU_OBJECT_BUFFER,
+    GPU_OBJECT_VERTEX_ARRAY,
+    GPU_OBJECT_PROGRAM,
+    GPU_OBJECT_TEXTURE,
+    GPU_OBJECT_FRAMEBUFFER,
+    GPU_OBJECT_RENDERBUFFER,
+    GPU_OBJECT_QUERY,
+    GPU_OBJECT_TYPES,
+};
+
+// Collects GL objects that are no longer used and deletes them in batches once
+// a fence shows the GPU has finished every frame that could still use them
+class DELETION_QUEUE {
+    public:
+        DELETION_QUEUE();
+        ~DELETION_QUEUE();
+        void enqueue(gpu_object_type type, GLuint name);
+        void end_frame();
+        void flush();
+        unsigned int get_pending_count();
+
+    private:
+        struct deletion_batch {
+            GLsync fence;
+            vector<GLuint> names[GPU_OBJECT_TYPES];
+        };
+
+        deletion_batch current;
+        deque<deletion_batch> waiting;
+
+        void delete_batch(deletion_batch& batch);
+};
+
+// Handles go through this queue when one is set, otherwise they delete right away
+void set_deletion_queue(DELETION_QUEUE* queue);
+void release_gpu_object(gpu_object_type type, GLuint name);
+
+// Move only owner of a single GL object name, releases it when it goes out of scope
+template <gpu_object_type TYPE>
+class GPU_HANDLE {
+    public:
+        GPU_HANDLE() {
+            name = 0;
+        }
+        explicit GPU_HANDLE(GLuint name) {
+            this->name = name;
+        }
+        ~GPU_HANDLE() {
+            reset(0);
+        }
+        GPU_HANDLE(GPU_HANDLE&& other) {
+            name = other.name;
+            other.name = 0;
+        }
+        GPU_HANDLE& operator=(GPU_HANDLE&& other) {
+            if (this != &other) {
+                reset(other.name);
+                other.name = 0;
+            }
+            return *this;
+        }
+        GPU_HANDLE(const GPU_HANDLE&) = delete;
+        GPU_HANDLE& operator=(const GPU_HANDLE&) = delete;
+
+        GLuint get() const {
+            return name;
+        }
+        void reset(GLuint new_name) {
+            if (name) {
+                release_gpu_object(TYPE, name);
+            }
+            name = new_name;
+        }
+
+    private:
+        GLuint name;
+};
+
+typedef GPU_HANDLE<GPU_OBJECT_BUFFER> GPU_BUFFER;
+typedef GPU_HANDLE<GPU_OBJECT_VERTEX_ARRAY> GPU_VERTEX_ARRAY;
+typedef GPU_HANDLE<GPU_OBJECT_PROGRAM> GPU_PROGRAM;
+typedef GPU_HANDLE<GPU_OBJECT_TEXTURE> GPU_TEXTURE;
+typedef GPU_HANDLE<GPU_OBJECT_FRAMEBUFFER> GPU_FRAMEBUFFER;
+typedef GPU_HANDLE<GPU_OBJECT_RENDERBUFFER> GPU_RENDERBUFFER;
+typedef GPU_HANDLE<GPU_OBJECT_QUERY> GPU_QUERY;
+
+GPU_BUFFER create_buffer();
+GPU_VERTEX_ARRAY create_vertex_array();
+GPU_TEXTURE create_texture();
+GPU_FRAMEBUFFER create_framebuffer();
+GPU_RENDERBUFFER create_renderbuffer();
+GPU_QUERY create_query();
+
+#endif
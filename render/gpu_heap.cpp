@@ -0,0 +1,128 @@
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+#include "../utils/log.hpp"
+#include "gpu_heap.hpp"
+
+#include <algorithm>
+
+// Every live heap, so the stats can be gathered per category at any time
+static vector<GPU_HEAP*> heaps;
+// Counters that outlive the heaps they came from
+static unsigned int total_allocations[GPU_MEMORY_CATEGORIES];
+static unsigned int total_frees[GPU_MEMORY_CATEGORIES];
+static unsigned int failed_allocations[GPU_MEMORY_CATEGORIES];
+
+GPU_HEAP::GPU_HEAP(gpu_memory_category category, GLenum usage, unsigned int n_buffers, size_t element_size, size_t capacity)
+    : allocator(capacity, max((size_t)1, GPU_HEAP_MIN_BLOCK_BYTES / element_size)) {
+    this->category = category;
+    this->element_size = element_size;
+
+    // The copy target leaves the vertex array and indirect bindings alone
+    for (unsigned int i = 0; i < n_buffers; i++) {
+        buffers.push_back(create_buffer());
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffers[i].get());
+        glBufferData(GL_COPY_WRITE_BUFFER, allocator.get_capacity() * element_size, NULL, usage);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    heaps.push_back(this);
+}
+
+GPU_HEAP::~GPU_HEAP() {
+    heaps.erase(remove(heaps.begin(), heaps.end(), this), heaps.end());
+}
+
+size_t GPU_HEAP::allocate(size_t count) {
+    size_t offset = allocator.allocate(count);
+    if (offset == BUDDY_INVALID_OFFSET) {
+        failed_allocations[category]++;
+        gl_log("ERROR: %s heap can not fit %zu elements, %zu of %zu free, largest block %zu\n",
+            get_gpu_memory_category_name(category), count,
+            allocator.get_free_size(), allocator.get_capacity(), allocator.get_largest_free_block());
+        return BUDDY_INVALID_OFFSET;
+    }
+    total_allocations[category]++;
+    return offset;
+}
+
+void GPU_HEAP::free(size_t offset) {
+    // Safe to reuse right away, glBufferSubData is ordered with the draws that read the old contents
+    allocator.free(offset);
+    total_frees[category]++;
+}
+
+void GPU_HEAP::write(unsigned int buffer, size_t offset, size_t count, const void* data) {
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffers[buffer].get());
+    glBufferSubData(GL_COPY_WRITE_BUFFER, offset * element_size, count * element_size, data);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+GLuint GPU_HEAP::get_buffer(unsigned int buffer) {
+    return buffers[buffer].get();
+}
+
+size_t GPU_HEAP::get_capacity() {
+    return allocator.get_capacity();
+}
+
+gpu_memory_category GPU_HEAP::get_category() {
+    return category;
+}
+
+void GPU_HEAP::add_stats(gpu_memory_stats& stats) {
+    size_t n_buffers = buffers.size();
+    stats.buffers += n_buffers;
+    stats.reserved_bytes += allocator.get_capacity() * element_size * n_buffers;
+    stats.live_bytes += allocator.get_requested_size() * element_size * n_buffers;
+    stats.allocated_bytes += allocator.get_allocated_size() * element_size * n_buffers;
+    // Buffers are allocated together, so a free block spans all of them like the free size does
+    size_t free_bytes = allocator.get_free_size() * element_size * n_buffers;
+    size_t largest_free_block = allocator.get_largest_free_block() * element_size * n_buffers;
+    stats.free_bytes += free_bytes;
+    stats.largest_free_block = max(stats.largest_free_block, largest_free_block);
+    stats.fragmented_bytes += free_bytes - largest_free_block;
+    stats.live_allocations += allocator.get_allocation_count();
+}
+
+const char* get_gpu_memory_category_name(gpu_memory_category category) {
+    switch (category) {
+        case GPU_MEMORY_VERTEX: return "vertex";
+        case GPU_MEMORY_INDEX: return "index";
+        case GPU_MEMORY_UNIFORM: return "uniform";
+        case GPU_MEMORY_INDIRECT: return "indirect";
+        default: return "unknown";
+    }
+}
+
+gpu_memory_stats get_gpu_memory_stats(gpu_memory_category category) {
+    gpu_memory_stats stats = {};
+    for (GPU_HEAP* heap : heaps) {
+        if (heap->get_category() == category) {
+            heap->add_stats(stats);
+        }
+    }
+    stats.total_allocations = total_allocations[category];
+    stats.total_frees = total_frees[category];
+    stats.failed_allocations = failed_allocations[category];
+    return stats;
+}
+
+void log_gpu_memory_stats() {
+    gl_log("GPU memory:\n");
+    for (int i = 0; i < GPU_MEMORY_CATEGORIES; i++) {
+        gpu_memory_stats stats = get_gpu_memory_stats((gpu_memory_category)i);
+        if (!stats.buffers && !stats.total_allocations) {
+            continue;
+        }
+        // External fragmentation, how much of the free space is not in the largest block of its heap.
+        // Per heap, several empty heaps of one category are not fragmented
+        float fragmentation = stats.free_bytes ? (float)stats.fragmented_bytes / stats.free_bytes : 0.0f;
+        gl_log("  %-8s %u buffers, %.2f of %.2f MiB live (%.2f MiB in blocks), %u live allocations, "
+            "%u allocated, %u freed, %u failed, fragmentation %.2f\n",
+            get_gpu_memory_category_name((gpu_memory_category)i), stats.buffers,
+            stats.live_bytes / 1048576.0, stats.reserved_bytes / 1048576.0, stats.allocated_bytes / 1048576.0,
+            stats.live_allocations, stats.total_allocations, stats.total_frees, stats.failed_allocations,
+            fragmentation);
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef GPU_HEAP_H
+#define GPU_HEAP_H
+
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+#include "../utils/buddy_allocator.hpp"
+#include "gl_handles.hpp"
+
+#include <stddef.h>
+#include <vector>
+using namespace std;
+
+// Smallest block handed out, smaller requests are rounded up to it
+#define GPU_HEAP_MIN_BLOCK_BYTES 256
+
+enum gpu_memory_category {
+    GPU_MEMORY_VERTEX,
+    GPU_MEMORY_INDEX,
+    GPU_MEMORY_UNIFORM,
+    GPU_MEMORY_INDIRECT,
+    GPU_MEMORY_CATEGORIES,
+};
+
+struct gpu_memory_stats {
+    unsigned int buffers;
+    size_t reserved_bytes;      // Size of the GL buffers
+    size_t live_bytes;          // What the live allocations asked for
+    size_t allocated_bytes;     // The same rounded up to buddy blocks
+    size_t free_bytes;
+    size_t largest_free_block; // Biggest single allocation that still fits, over all buffers of its heap
+    size_t fragmented_bytes;    // Free space outside the largest free block of each heap
+    unsigned int live_allocations;
+    unsigned int total_allocations;
+    unsigned int total_frees;
+    unsigned int failed_allocations;
+};
+
+// A few large GL buffers carved up with a buddy allocator, so a mesh costs an offset and not a buffer.
+// All buffers of a heap share the same layout and are allocated together, for example
+// positions and colors, so one offset addresses the same element in each of them.
+// Offsets and counts are in elements, not bytes.
+class GPU_HEAP {
+    public:
+        GPU_HEAP(gpu_memory_category category, GLenum usage, unsigned int n_buffers, size_t element_size, size_t capacity);
+        ~GPU_HEAP();
+        GPU_HEAP(const GPU_HEAP&) = delete;
+        GPU_HEAP& operator=(const GPU_HEAP&) = delete;
+
+        size_t allocate(size_t count);
+        void free(size_t offset);
+        void write(unsigned int buffer, size_t offset, size_t count, const void* data);
+        GLuint get_buffer(unsigned int buffer);
+        size_t get_capacity();
+        gpu_memory_category get_category();
+        void add_stats(gpu_memory_stats& stats);
+
+    private:
+        gpu_memory_category category;
+        size_t element_size;
+        BUDDY_ALLOCATOR allocator;
+        vector<GPU_BUFFER> buffers;
+};
+
+const char* get_gpu_memory_category_name(gpu_memory_category category);
+gpu_memory_stats get_gpu_memory_stats(gpu_memory_category category);
+// Writes one line per category to the gl log
+void log_gpu_memory_stats();
+
+#endif
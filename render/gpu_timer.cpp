@@ -0,0 +1,50 @@
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+#include "gpu_timer.hpp"
+
+GPU_TIMER::GPU_TIMER() {
+    for (int i = 0; i < GPU_TIMER_QUERIES; i++) {
+        queries[i] = create_query();
+    }
+    next_query = 0;
+    oldest_query = 0;
+    pending = 0;
+}
+
+void GPU_TIMER::begin() {
+    // All queries still in flight, skip this one rather than stall
+    if (pending == GPU_TIMER_QUERIES) {
+        return;
+    }
+    glBeginQuery(GL_TIME_ELAPSED, queries[next_query].get());
+}
+
+void GPU_TIMER::end() {
+    if (pending == GPU_TIMER_QUERIES) {
+        return;
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    next_query = (next_query + 1) % GPU_TIMER_QUERIES;
+    pending++;
+}
+
+// The newest finished result, false when nothing finished since the last call
+bool GPU_TIMER::get_elapsed(double* seconds) {
+    bool found = false;
+    while (pending > 0) {
+        GLuint query = queries[oldest_query].get();
+        GLint available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+        *seconds = nanoseconds * 1e-9;
+        found = true;
+        oldest_query = (oldest_query + 1) % GPU_TIMER_QUERIES;
+        pending--;
+    }
+    return found;
+}
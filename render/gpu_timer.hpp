@@ -0,0 +1,27 @@
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+#include "gl_handles.hpp"
+
+#define GPU_TIMER_QUERIES 4
+
+// GPU time of a span of commands, with a ring of queries so reading a result never
+// waits for the GPU. Results come in a few frames after the work was issued.
+class GPU_TIMER {
+    public:
+        GPU_TIMER();
+        void begin();
+        void end();
+        bool get_elapsed(double* seconds);
+
+    private:
+        GPU_QUERY queries[GPU_TIMER_QUERIES];
+        unsigned int next_query;    // Where the next begin goes
+        unsigned int oldest_query;  // The first one still waiting for a result
+        unsigned int pending;
+};
+
+#endif
@@ -0,0 +1,17 @@
+#include "indirect.hpp"
+
+void build_indirect_commands(
+    const vector<mesh_range>& meshes,
+    const vector<unsigned int>& draw_list,
+    vector<draw_elements_indirect_command>& commands) {
+        commands.resize(draw_list.size());
+        for (size_t i = 0; i < draw_list.size(); i++) {
+            const mesh_range& mesh = meshes[draw_list[i]];
+            draw_elements_indirect_command& command = commands[i];
+            command.count = mesh.index_count;
+            command.instance_count = 1;
+            command.first_index = mesh.first_index;
+            command.base_vertex = mesh.base_vertex;
+            command.base_instance = (unsigned int)i;
+        }
+}
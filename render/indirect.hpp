@@ -0,0 +1,32 @@
+#ifndef INDIRECT_H
+#define INDIRECT_H
+
+#include <vector>
+using namespace std;
+
+// Same memory layout as the DrawElementsIndirectCommand struct from the GL spec,
+// so an array of these can be copied straight into a GL_DRAW_INDIRECT_BUFFER
+struct draw_elements_indirect_command {
+    unsigned int count;
+    unsigned int instance_count;
+    unsigned int first_index;
+    int base_vertex;
+    unsigned int base_instance;
+};
+
+// Where a mesh lives inside the shared vertex/index pool
+struct mesh_range {
+    unsigned int first_index;
+    unsigned int index_count;
+    int base_vertex;
+};
+
+// Builds one command per entry of draw_list (indices into meshes). The base instance
+// is the position in draw_list, so per draw data (transforms) can be stored in the same order.
+// Does not touch GL, so it can be run and checked without a context.
+void build_indirect_commands(
+    const vector<mesh_range>& meshes,
+    const vector<unsigned int>& draw_list,
+    vector<draw_elements_indirect_command>& commands);
+
+#endif
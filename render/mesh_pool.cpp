@@ -0,0 +1,345 @@
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+#include "../glm/glm.hpp"
+#include "../glm/gtc/matrix_transform.hpp"
+#include "../glm/gtc/type_ptr.hpp"
+
+#include "../utils/log.hpp"
+#include "../shapes/mesh_optimizer.hpp"
+#include "../shapes/simplify.hpp"
+#include "shader_cache.hpp"
+#include "mesh_pool.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+MESH_POOL::MESH_POOL(unsigned int max_vertices, unsigned int max_indices, unsigned int max_draws, unsigned int index_size)
+    : vertex_heap(GPU_MEMORY_VERTEX, GL_STATIC_DRAW, 2, 3 * sizeof(float), max_vertices),
+      index_heap(GPU_MEMORY_INDEX, GL_STATIC_DRAW, 1, index_size, max_indices),
+      transform_heap(GPU_MEMORY_UNIFORM, GL_STREAM_DRAW, 1, sizeof(glm::mat4), max_draws),
+      indirect_heap(GPU_MEMORY_INDIRECT, GL_STREAM_DRAW, 1, sizeof(draw_elements_indirect_command), max_draws) {
+    this->max_draws = max_draws;
+    this->index_size = index_size;
+    index_type = index_size == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    pixels_per_ndc = glm::vec2(400.0f, 400.0f);
+
+    // Per draw data is rewritten every frame, one range for all of it
+    transform_offset = transform_heap.allocate(max_draws);
+    indirect_offset = indirect_heap.allocate(max_draws);
+
+    vao = create_vertex_array();
+    glBindVertexArray(vao.get());
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertex_heap.get_buffer(0));
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), NULL);
+    glEnableVertexAttribArray(0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertex_heap.get_buffer(1));
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), NULL);
+    glEnableVertexAttribArray(1);
+
+    // One mat4 per draw, a mat4 attribute takes 4 locations (one per column).
+    // The divisor makes it advance per instance, which the base instance of every command selects
+    glBindBuffer(GL_ARRAY_BUFFER, transform_heap.get_buffer(0));
+    for (int i = 0; i < 4; i++) {
+        void* column = (void*)(transform_offset * sizeof(glm::mat4) + i * sizeof(glm::vec4));
+        glVertexAttribPointer(2 + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), column);
+        glVertexAttribDivisor(2 + i, 1);
+        glEnableVertexAttribArray(2 + i);
+    }
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_heap.get_buffer(0));
+
+    glBindVertexArray(0);
+
+    // Multi draw indirect is GL 4.3, macOS stops at 4.1. There every mesh is its own draw
+    // with the transform as a uniform, which the base variant of the shader reads
+    multi_draw_indirect = GLAD_GL_VERSION_4_3 != 0;
+    if (!multi_draw_indirect) {
+        gl_log("no OpenGL 4.3, meshes are drawn one call each instead of multi draw indirect\n");
+    }
+    shader_programme = get_shader_program("test_vs.glsl", "test_fs.glsl",
+        multi_draw_indirect ? SHADER_INSTANCED_TRANSFORM : 0);
+}
+
+int MESH_POOL::add_mesh(const mesh_data& mesh) {
+    scene_shape_lods lods;
+    if (!make_scene_lods(mesh, lods)) {
+        return -1;
+    }
+    aabb mesh_bounds = get_mesh_bounds(mesh);
+    scene_shape_record shape;
+    shape.first_index = 0;
+    shape.index_count = mesh.indices.size();
+    shape.base_vertex = 0;
+    shape.vertex_count = mesh.positions.size() / 3;
+    shape.bounds[0] = mesh_bounds.min_x;
+    shape.bounds[1] = mesh_bounds.min_y;
+    shape.bounds[2] = mesh_bounds.max_x;
+    shape.bounds[3] = mesh_bounds.max_y;
+    return add_mesh_block(
+        mesh.positions.data(), mesh.colors.data(), shape.vertex_count,
+        mesh.indices.data(), sizeof(unsigned int), shape.index_count, &shape, 1, &lods);
+}
+
+int MESH_POOL::add_mesh_block(
+    const float* positions, const float* colors, unsigned int block_vertices,
+    const void* indices, unsigned int block_index_size, unsigned int block_indices,
+    const scene_shape_record* shapes, unsigned int n_shapes, const scene_shape_lods* lods) {
+        // Ids of removed blocks are reused first, so removing blocks gives draw slots back
+        int first_mesh = find_free_ids(n_shapes);
+        if (first_mesh < 0 && lod_counts.size() + n_shapes > max_draws) {
+            gl_log("ERROR: mesh pool is full, block of %u meshes with %u vertices not added\n", n_shapes, block_vertices);
+            return -1;
+        }
+
+        // Convert the indices when the block does not match the pool, only copies when it has to
+        if (block_index_size != index_size) {
+            if (index_size == 2) {
+                // Indices are local to each level, so levels are checked one by one
+                for (unsigned int i = 0; i < n_shapes; i++) {
+                    unsigned int n_levels = lods ? lods[i].n_levels : 1;
+                    for (unsigned int level = 0; level < n_levels; level++) {
+                        unsigned int vertex_count = lods ? lods[i].levels[level].vertex_count : shapes[i].vertex_count;
+                        if (vertex_count > 65536) {
+                            gl_log("ERROR: mesh with %u vertices does not fit 16 bit indices\n", vertex_count);
+                            release_ids(first_mesh, n_shapes);
+                            return -1;
+                        }
+                    }
+                }
+                short_indices.resize(block_indices);
+                narrow_indices((const unsigned int*)indices, block_indices, short_indices.data());
+                indices = short_indices.data();
+            } else {
+                const uint16_t* source = (const uint16_t*)indices;
+                long_indices.assign(source, source + block_indices);
+                indices = long_indices.data();
+            }
+        }
+
+        size_t first_vertex = vertex_heap.allocate(block_vertices);
+        if (first_vertex == BUDDY_INVALID_OFFSET) {
+            release_ids(first_mesh, n_shapes);
+            return -1;
+        }
+        size_t first_index = index_heap.allocate(block_indices);
+        if (first_index == BUDDY_INVALID_OFFSET) {
+            vertex_heap.free(first_vertex);
+            release_ids(first_mesh, n_shapes);
+            return -1;
+        }
+
+        // One copy per buffer for the whole block, the data can come straight from a mapped file
+        vertex_heap.write(0, first_vertex, block_vertices, positions);
+        vertex_heap.write(1, first_vertex, block_vertices, colors);
+        index_heap.write(0, first_index, block_indices, indices);
+
+        if (first_mesh < 0) {
+            first_mesh = lod_counts.size();
+            unsigned int n_meshes = first_mesh + n_shapes;
+            lod_ranges.resize(n_meshes * SCENE_MAX_LODS);
+            lod_errors.resize(n_meshes * SCENE_MAX_LODS);
+            lod_counts.resize(n_meshes);
+            bounds.resize(n_meshes);
+            transforms.resize(n_meshes);
+        }
+
+        // Indices stay local to the level, the base vertex offsets them into the pool.
+        // Shapes without level records are a single level covering the whole shape
+        for (unsigned int i = 0; i < n_shapes; i++) {
+            const scene_shape_record& shape = shapes[i];
+            scene_lod_level whole = {0, shape.index_count, 0, shape.vertex_count, 0.0f};
+            const scene_lod_level* levels = lods ? lods[i].levels : &whole;
+            unsigned int id = first_mesh + i;
+            lod_counts[id] = lods ? lods[i].n_levels : 1;
+            for (unsigned int level = 0; level < lod_counts[id]; level++) {
+                mesh_range range;
+                range.first_index = first_index + shape.first_index + levels[level].first_index;
+                range.index_count = levels[level].index_count;
+                range.base_vertex = first_vertex + shape.base_vertex + levels[level].first_vertex;
+                lod_ranges[id * SCENE_MAX_LODS + level] = range;
+                lod_errors[id * SCENE_MAX_LODS + level] = levels[level].error;
+            }
+            aabb shape_bounds = {shape.bounds[0], shape.bounds[1], shape.bounds[2], shape.bounds[3]};
+            bounds[id] = shape_bounds;
+            transforms[id] = glm::mat4(1.0f);
+            all_meshes.push_back(id);
+        }
+
+        mesh_block block;
+        block.first_mesh = first_mesh;
+        block.n_meshes = n_shapes;
+        block.first_vertex = first_vertex;
+        block.first_index = first_index;
+        blocks.push_back(block);
+        return first_mesh;
+}
+
+void MESH_POOL::remove_mesh_block(int first_mesh, SPATIAL_GRID* spatial_grid) {
+    for (size_t i = 0; i < blocks.size(); i++) {
+        if (blocks[i].first_mesh != first_mesh) {
+            continue;
+        }
+        vertex_heap.free(blocks[i].first_vertex);
+        index_heap.free(blocks[i].first_index);
+
+        // The ids draw nothing until a new block takes them over
+        int last_mesh = first_mesh + blocks[i].n_meshes;
+        for (int id = first_mesh; id < last_mesh; id++) {
+            lod_counts[id] = 0;
+            lod_ranges[id * SCENE_MAX_LODS].index_count = 0;
+            if (spatial_grid) {
+                spatial_grid->remove(id);
+            }
+        }
+        all_meshes.erase(remove_if(all_meshes.begin(), all_meshes.end(), [&](unsigned int id) {
+            return (int)id >= first_mesh && (int)id < last_mesh;
+        }), all_meshes.end());
+        release_ids(first_mesh, blocks[i].n_meshes);
+
+        blocks[i] = blocks.back();
+        blocks.pop_back();
+        return;
+    }
+}
+
+// First fit over the id ranges of removed blocks, -1 when none is big enough
+int MESH_POOL::find_free_ids(unsigned int n_meshes) {
+    for (size_t i = 0; i < free_ids.size(); i++) {
+        if (free_ids[i].n_meshes < n_meshes) {
+            continue;
+        }
+        int first_mesh = free_ids[i].first_mesh;
+        free_ids[i].first_mesh += n_meshes;
+        free_ids[i].n_meshes -= n_meshes;
+        if (free_ids[i].n_meshes == 0) {
+            free_ids.erase(free_ids.begin() + i);
+        }
+        return first_mesh;
+    }
+    return -1;
+}
+
+// Kept sorted and merged with its neighbours, so freed ranges can be reused by bigger blocks
+void MESH_POOL::release_ids(int first_mesh, unsigned int n_meshes) {
+    if (first_mesh < 0 || n_meshes == 0) {
+        return;
+    }
+    id_range range = {first_mesh, n_meshes};
+    vector<id_range>::iterator next = lower_bound(free_ids.begin(), free_ids.end(), range,
+        [](const id_range& a, const id_range& b) { return a.first_mesh < b.first_mesh; });
+    next = free_ids.insert(next, range);
+    if (next + 1 != free_ids.end() && next->first_mesh + (int)next->n_meshes == (next + 1)->first_mesh) {
+        next->n_meshes += (next + 1)->n_meshes;
+        free_ids.erase(next + 1);
+    }
+    if (next != free_ids.begin() && (next - 1)->first_mesh + (int)(next - 1)->n_meshes == next->first_mesh) {
+        (next - 1)->n_meshes += next->n_meshes;
+        free_ids.erase(next);
+    }
+}
+
+void MESH_POOL::set_transform(int mesh_id, const glm::mat4& transform) {
+    transforms[mesh_id] = transform;
+}
+
+// Size of the target the meshes are drawn into, in pixels
+void MESH_POOL::set_viewport_size(int width, int height) {
+    pixels_per_ndc = glm::vec2(0.5f * width, 0.5f * height);
+}
+
+unsigned int MESH_POOL::get_mesh_count() {
+    return lod_counts.size();
+}
+
+void MESH_POOL::record(RENDER_LIST& list) {
+    record(list, all_meshes);
+}
+
+// Builds this frame's commands and transforms, the packet uploads them right before the draw.
+// No GL calls, so any thread can record it, but only once per frame as the packet points at the data
+void MESH_POOL::record(RENDER_LIST& list, const vector<unsigned int>& draw_list) {
+    if (draw_list.empty()) {
+        return;
+    }
+
+    // Transforms are stored in draw order, matching the base instance of each command
+    draw_transforms.resize(draw_list.size());
+    draw_levels.resize(draw_list.size());
+    for (size_t i = 0; i < draw_list.size(); i++) {
+        unsigned int mesh_id = draw_list[i];
+        draw_transforms[i] = transforms[mesh_id];
+        draw_levels[i] = mesh_id * SCENE_MAX_LODS + select_lod(mesh_id);
+    }
+
+    if (!multi_draw_indirect) {
+        record_each(list);
+        return;
+    }
+
+    build_indirect_commands(lod_ranges, draw_levels, commands);
+
+    draw_packet packet = {};
+    packet.key = make_sort_key(RENDER_LAYER_WORLD, shader_programme, vao.get(), 0.0f, false);
+    packet.program = shader_programme;
+    packet.vao = vao.get();
+    packet.mode = GL_TRIANGLES;
+    packet.index_type = index_type;
+    // Every mesh in the list with one call, no matter what shape it is
+    packet.count = commands.size();
+    packet.offset = indirect_offset * sizeof(draw_elements_indirect_command);
+    packet.indirect_buffer = indirect_heap.get_buffer(0);
+    packet.uploads[0].buffer = transform_heap.get_buffer(0);
+    packet.uploads[0].offset = transform_offset * sizeof(glm::mat4);
+    packet.uploads[0].size = draw_transforms.size() * sizeof(glm::mat4);
+    packet.uploads[0].data = draw_transforms.data();
+    packet.uploads[1].buffer = indirect_heap.get_buffer(0);
+    packet.uploads[1].offset = packet.offset;
+    packet.uploads[1].size = commands.size() * sizeof(draw_elements_indirect_command);
+    packet.uploads[1].data = commands.data();
+    packet.n_uploads = 2;
+    list.add(packet);
+}
+
+// Projected bounds of the mesh give how many pixels one of its units covers, the level
+// error is in the same units. Transforms translate and scale, so the corners are enough
+int MESH_POOL::select_lod(unsigned int mesh_id) {
+    unsigned int n_levels = lod_counts[mesh_id];
+    if (n_levels < 2) {
+        return 0;
+    }
+    const aabb& box = bounds[mesh_id];
+    glm::vec4 low = transforms[mesh_id] * glm::vec4(box.min_x, box.min_y, 0.0f, 1.0f);
+    glm::vec4 high = transforms[mesh_id] * glm::vec4(box.max_x, box.max_y, 0.0f, 1.0f);
+    float pixels_per_unit = 0.0f;
+    if (box.max_x > box.min_x) {
+        pixels_per_unit = max(pixels_per_unit, fabsf(high.x - low.x) * pixels_per_ndc.x / (box.max_x - box.min_x));
+    }
+    if (box.max_y > box.min_y) {
+        pixels_per_unit = max(pixels_per_unit, fabsf(high.y - low.y) * pixels_per_ndc.y / (box.max_y - box.min_y));
+    }
+    return select_polygon_lod(&lod_errors[mesh_id * SCENE_MAX_LODS], n_levels, pixels_per_unit, MESH_POOL_LOD_PIXEL_ERROR);
+}
+
+// Fallback without multi draw indirect, one packet per mesh that sets its own transform
+void MESH_POOL::record_each(RENDER_LIST& list) {
+    size_t index_bytes = index_type == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int);
+    for (size_t i = 0; i < draw_levels.size(); i++) {
+        const mesh_range& mesh = lod_ranges[draw_levels[i]];
+        if (mesh.index_count == 0) {
+            continue;
+        }
+        draw_packet packet = {};
+        packet.key = make_sort_key(RENDER_LAYER_WORLD, shader_programme, vao.get(), 0.0f, false);
+        packet.program = shader_programme;
+        packet.vao = vao.get();
+        packet.mode = GL_TRIANGLES;
+        packet.index_type = index_type;
+        packet.count = mesh.index_count;
+        packet.offset = mesh.first_index * index_bytes;
+        packet.base_vertex = mesh.base_vertex;
+        packet.transform = glm::value_ptr(draw_transforms[i]);
+        list.add(packet);
+    }
+}
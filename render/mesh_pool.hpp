@@ -0,0 +1,91 @@
+#ifndef MESH_POOL_H
+#define MESH_POOL_H
+
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+#include "../glm/glm.hpp"
+
+#include "../shapes/mesh.hpp"
+#include "../utils/scene_file.hpp"
+#include "../utils/spatial_grid.hpp"
+#include "indirect.hpp"
+#include "gl_handles.hpp"
+#include "gpu_heap.hpp"
+#include "render_queue.hpp"
+
+#include <stdint.h>
+#include <vector>
+using namespace std;
+
+// All meshes share one vertex/index pool and are drawn with a single
+// glMultiDrawElementsIndirect call. Without an OpenGL 4.3 context (macOS) every
+// mesh gets a glDrawElementsBaseVertex call of its own instead.
+// Indices are 2 or 4 bytes for the whole pool, with 2 bytes no single mesh can
+// have more than 65536 vertices (indices are local to each mesh).
+// Every block of meshes gets its own range of the vertex and index heaps,
+// so a block can be removed again and its space and mesh ids reused.
+// A mesh can have up to SCENE_MAX_LODS levels of detail, each drawn mesh uses the coarsest
+// level whose error stays under MESH_POOL_LOD_PIXEL_ERROR at its size on screen.
+#define MESH_POOL_LOD_PIXEL_ERROR 0.5f
+
+class MESH_POOL {
+    public:
+        MESH_POOL(unsigned int max_vertices, unsigned int max_indices, unsigned int max_draws, unsigned int index_size);
+        int add_mesh(const mesh_data& mesh);
+        int add_mesh_block(
+            const float* positions, const float* colors, unsigned int block_vertices,
+            const void* indices, unsigned int block_index_size, unsigned int block_indices,
+            const scene_shape_record* shapes, unsigned int n_shapes, const scene_shape_lods* lods = NULL);
+        void remove_mesh_block(int first_mesh, SPATIAL_GRID* spatial_grid);
+        void set_transform(int mesh_id, const glm::mat4& transform);
+        void set_viewport_size(int width, int height);
+        unsigned int get_mesh_count();
+        void record(RENDER_LIST& list);
+        void record(RENDER_LIST& list, const vector<unsigned int>& draw_list);
+
+    private:
+        struct mesh_block {
+            int first_mesh;
+            unsigned int n_meshes;
+            size_t first_vertex;
+            size_t first_index;
+        };
+        struct id_range {
+            int first_mesh;
+            unsigned int n_meshes;
+        };
+
+        GPU_HEAP vertex_heap; // Positions and colors
+        GPU_HEAP index_heap;
+        GPU_HEAP transform_heap;
+        GPU_HEAP indirect_heap;
+        size_t transform_offset;
+        size_t indirect_offset;
+        GPU_VERTEX_ARRAY vao;
+        GLuint shader_programme; // Owned by the shader cache
+        unsigned int max_draws;
+        unsigned int index_size;
+        GLenum index_type;
+        bool multi_draw_indirect;
+        vector<mesh_block> blocks;
+        vector<id_range> free_ids; // Mesh ids of removed blocks, sorted
+        vector<mesh_range> lod_ranges; // SCENE_MAX_LODS per mesh id, finest first
+        vector<float> lod_errors; // Same layout as lod_ranges
+        vector<unsigned int> lod_counts; // Levels per mesh id, 0 once its block is removed
+        vector<aabb> bounds; // Before the transform
+        vector<glm::mat4> transforms;
+        glm::vec2 pixels_per_ndc; // Half the viewport
+        vector<unsigned int> all_meshes;
+        vector<draw_elements_indirect_command> commands;
+        vector<glm::mat4> draw_transforms;
+        vector<unsigned int> draw_levels; // Index into lod_ranges per draw
+        vector<uint16_t> short_indices;
+        vector<unsigned int> long_indices;
+
+        int select_lod(unsigned int mesh_id);
+        void record_each(RENDER_LIST& list);
+        int find_free_ids(unsigned int n_meshes);
+        void release_ids(int first_mesh, unsigned int n_meshes);
+};
+
+#endif
@@ -0,0 +1,107 @@
+#include "render_queue.hpp"
+
+#include <string.h>
+
+uint64_t make_sort_key(render_layer layer, unsigned int program, unsigned int vao, float depth, bool translucent) {
+    depth = depth < 0.0f ? 0.0f : (depth > 1.0f ? 1.0f : depth);
+    uint64_t depth_bits = (uint64_t)(depth * 0xffffff);
+    uint64_t state_bits = ((uint64_t)(program & 0xfff) << 12) | (vao & 0xfff);
+    uint64_t key = (uint64_t)(layer & 0xff) << 56;
+    if (translucent) {
+        // Far first, so blending composes correctly
+        key |= (0xffffff - depth_bits) << 32 | state_bits << 8;
+    } else {
+        key |= state_bits << 32 | depth_bits << 8;
+    }
+    return key;
+}
+
+unsigned int get_state_changes(const draw_packet* previous, const draw_packet& current) {
+    if (!previous) {
+        return RENDER_CHANGE_PROGRAM | RENDER_CHANGE_VAO | RENDER_CHANGE_TEXTURE |
+            RENDER_CHANGE_BLEND | RENDER_CHANGE_INDIRECT_BUFFER;
+    }
+    unsigned int changes = 0;
+    if (previous->program != current.program) {
+        changes |= RENDER_CHANGE_PROGRAM;
+    }
+    if (previous->vao != current.vao) {
+        changes |= RENDER_CHANGE_VAO;
+    }
+    if (previous->texture != current.texture) {
+        changes |= RENDER_CHANGE_TEXTURE;
+    }
+    if (previous->blend != current.blend) {
+        changes |= RENDER_CHANGE_BLEND;
+    }
+    if (previous->indirect_buffer != current.indirect_buffer) {
+        changes |= RENDER_CHANGE_INDIRECT_BUFFER;
+    }
+    return changes;
+}
+
+void add_state_changes(unsigned int changes, render_queue_stats& stats) {
+    stats.packets++;
+    stats.program_changes += (changes & RENDER_CHANGE_PROGRAM) != 0;
+    stats.vao_changes += (changes & RENDER_CHANGE_VAO) != 0;
+    stats.texture_changes += (changes & RENDER_CHANGE_TEXTURE) != 0;
+    stats.blend_changes += (changes & RENDER_CHANGE_BLEND) != 0;
+    stats.indirect_buffer_changes += (changes & RENDER_CHANGE_INDIRECT_BUFFER) != 0;
+}
+
+void radix_sort_packets(vector<draw_packet>& packets, vector<draw_packet>& scratch) {
+    scratch.resize(packets.size());
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t counts[256];
+        memset(counts, 0, sizeof(counts));
+        for (const draw_packet& packet : packets) {
+            counts[(packet.key >> shift) & 0xff]++;
+        }
+        // Every key has the same byte here, this pass would not move anything
+        if (counts[(packets[0].key >> shift) & 0xff] == packets.size()) {
+            continue;
+        }
+        size_t offset = 0;
+        for (int i = 0; i < 256; i++) {
+            size_t count = counts[i];
+            counts[i] = offset;
+            offset += count;
+        }
+        for (const draw_packet& packet : packets) {
+            scratch[counts[(packet.key >> shift) & 0xff]++] = packet;
+        }
+        packets.swap(scratch);
+    }
+}
+
+void RENDER_LIST::add(const draw_packet& packet) {
+    packets.push_back(packet);
+}
+
+void RENDER_QUEUE::submit_list(RENDER_LIST& list) {
+    lock_guard<mutex> lock(packets_mutex);
+    packets.insert(packets.end(), list.packets.begin(), list.packets.end());
+    list.packets.clear();
+}
+
+void RENDER_QUEUE::sort() {
+    if (!packets.empty()) {
+        radix_sort_packets(packets, scratch);
+    }
+}
+
+void RENDER_QUEUE::clear() {
+    packets.clear();
+}
+
+const vector<draw_packet>& RENDER_QUEUE::get_packets() {
+    return packets;
+}
+
+render_queue_stats RENDER_QUEUE::count_state_changes() {
+    render_queue_stats stats = {};
+    for (size_t i = 0; i < packets.size(); i++) {
+        add_state_changes(get_state_changes(i ? &packets[i - 1] : NULL, packets[i]), stats);
+    }
+    return stats;
+}
@@ -0,0 +1,93 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <mutex>
+#include <vector>
+using namespace std;
+
+// Draws sort by layer first, the rest of the key depends on the layer:
+//   opaque       layer:8 | program:12 | vao:12 | depth:24 | unused:8   (front to back)
+//   translucent  layer:8 | depth:24 | program:12 | vao:12 | unused:8   (back to front)
+enum render_layer {
+    RENDER_LAYER_WORLD,
+    RENDER_LAYER_SPRITES,
+    RENDER_LAYER_OVERLAY,
+};
+
+enum render_state_change {
+    RENDER_CHANGE_PROGRAM = 1,
+    RENDER_CHANGE_VAO = 2,
+    RENDER_CHANGE_TEXTURE = 4,
+    RENDER_CHANGE_BLEND = 8,
+    RENDER_CHANGE_INDIRECT_BUFFER = 16,
+};
+
+// Copied into a buffer right before the draw, the data has to stay alive until the queue is submitted
+struct buffer_upload {
+    unsigned int buffer;
+    size_t offset;
+    size_t size;
+    const void* data;
+};
+
+// Everything one draw needs, GL names and enums are kept as plain integers
+// so packets can be recorded and sorted without a context
+struct draw_packet {
+    uint64_t key;
+    unsigned int program;
+    unsigned int vao;
+    unsigned int texture;           // Bound to unit 0, 0 for none
+    bool blend;                     // Alpha blended and without depth test
+    unsigned int mode;
+    unsigned int index_type;
+    unsigned int count;             // Indices, or commands when drawing indirect
+    size_t offset;                  // Bytes into the index or the indirect buffer
+    int base_vertex;                // Added to every index, plain draws only
+    unsigned int indirect_buffer;   // Multi draw indirect when set
+    const float* transform;         // Column major mat4 for the "transform" uniform, NULL to leave it alone
+    buffer_upload uploads[2];
+    unsigned int n_uploads;
+};
+
+struct render_queue_stats {
+    unsigned int packets;
+    unsigned int program_changes;
+    unsigned int vao_changes;
+    unsigned int texture_changes;
+    unsigned int blend_changes;
+    unsigned int indirect_buffer_changes;
+};
+
+// depth is 0 (near) to 1 (far)
+uint64_t make_sort_key(render_layer layer, unsigned int program, unsigned int vao, float depth, bool translucent);
+// What has to be rebound going from one packet to the next, previous is NULL for the first
+unsigned int get_state_changes(const draw_packet* previous, const draw_packet& current);
+void add_state_changes(unsigned int changes, render_queue_stats& stats);
+// Stable LSD radix sort on the keys, bytes that are the same in every key are skipped
+void radix_sort_packets(vector<draw_packet>& packets, vector<draw_packet>& scratch);
+
+// Packets recorded by one thread, no locking while recording
+class RENDER_LIST {
+    public:
+        void add(const draw_packet& packet);
+        vector<draw_packet> packets;
+};
+
+// Any thread hands in whole lists, the render thread sorts once and submits in key order
+class RENDER_QUEUE {
+    public:
+        void submit_list(RENDER_LIST& list);
+        void sort();
+        void clear();
+        const vector<draw_packet>& get_packets();
+        render_queue_stats count_state_changes();
+
+    private:
+        mutex packets_mutex;
+        vector<draw_packet> packets;
+        vector<draw_packet> scratch;
+};
+
+#endif
@@ -0,0 +1,68 @@
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+#include "render_submit.hpp"
+
+render_queue_stats submit_render_queue(RENDER_QUEUE& queue, render_layer first_layer, render_layer last_layer) {
+    render_queue_stats stats = {};
+    const vector<draw_packet>& packets = queue.get_packets();
+    const draw_packet* previous = NULL;
+    GLint transform_location = -1;
+    for (size_t i = 0; i < packets.size(); i++) {
+        // Sorted by layer, so the range is one run of packets
+        unsigned int layer = packets[i].key >> 56;
+        if (layer < (unsigned int)first_layer || layer > (unsigned int)last_layer) {
+            continue;
+        }
+        const draw_packet& packet = packets[i];
+        unsigned int changes = get_state_changes(previous, packet);
+        previous = &packet;
+        add_state_changes(changes, stats);
+
+        if (changes & RENDER_CHANGE_PROGRAM) {
+            glUseProgram(packet.program);
+            transform_location = glGetUniformLocation(packet.program, "transform");
+        }
+        if (packet.transform) {
+            glUniformMatrix4fv(transform_location, 1, GL_FALSE, packet.transform);
+        }
+        if (changes & RENDER_CHANGE_VAO) {
+            glBindVertexArray(packet.vao);
+        }
+        if (changes & RENDER_CHANGE_TEXTURE) {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, packet.texture);
+        }
+        if (changes & RENDER_CHANGE_BLEND) {
+            if (packet.blend) {
+                glDisable(GL_DEPTH_TEST);
+                glEnable(GL_BLEND);
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            } else {
+                glDisable(GL_BLEND);
+                glEnable(GL_DEPTH_TEST);
+            }
+        }
+        if (changes & RENDER_CHANGE_INDIRECT_BUFFER) {
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, packet.indirect_buffer);
+        }
+
+        for (unsigned int j = 0; j < packet.n_uploads; j++) {
+            const buffer_upload& upload = packet.uploads[j];
+            glBindBuffer(GL_COPY_WRITE_BUFFER, upload.buffer);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, upload.offset, upload.size, upload.data);
+        }
+
+        if (packet.indirect_buffer) {
+            glMultiDrawElementsIndirect(packet.mode, packet.index_type, (void*)packet.offset, packet.count, 0);
+        } else {
+            glDrawElementsBaseVertex(packet.mode, packet.count, packet.index_type, (void*)packet.offset, packet.base_vertex);
+        }
+    }
+
+    // Leave the defaults the rest of the frame expects
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+    return stats;
+}
@@ -0,0 +1,15 @@
+#ifndef RENDER_SUBMIT_H
+#define RENDER_SUBMIT_H
+
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+#include "render_queue.hpp"
+
+// Issues the packets of a sorted queue in order, only binding what differs from the previous packet.
+// Render thread only, it is the one place the queue touches GL.
+// A layer range submits part of the queue, for passes into different framebuffers.
+render_queue_stats submit_render_queue(RENDER_QUEUE& queue,
+    render_layer first_layer = RENDER_LAYER_WORLD, render_layer last_layer = RENDER_LAYER_OVERLAY);
+
+#endif
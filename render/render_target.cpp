@@ -0,0 +1,74 @@
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+#include "../utils/log.hpp"
+#include "render_target.hpp"
+
+RENDER_TARGET::RENDER_TARGET(int width, int height) {
+    framebuffer = create_framebuffer();
+    this->width = 0;
+    this->height = 0;
+    resize(width, height);
+}
+
+void RENDER_TARGET::resize(int width, int height) {
+    // A minimized window reports 0 by 0
+    width = width < 1 ? 1 : width;
+    height = height < 1 ? 1 : height;
+    if (width == this->width && height == this->height) {
+        return;
+    }
+    this->width = width;
+    this->height = height;
+    scaled_width = width;
+    scaled_height = height;
+
+    // New storage, the old renderbuffers go through the deletion queue
+    color = create_renderbuffer();
+    glBindRenderbuffer(GL_RENDERBUFFER, color.get());
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    depth = create_renderbuffer();
+    glBindRenderbuffer(GL_RENDERBUFFER, depth.get());
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.get());
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color.get());
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth.get());
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        gl_log("ERROR: render target %ix%i is incomplete\n", width, height);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void RENDER_TARGET::bind(float scale) {
+    scaled_width = (int)(width * scale + 0.5f);
+    scaled_height = (int)(height * scale + 0.5f);
+    scaled_width = scaled_width < 1 ? 1 : scaled_width;
+    scaled_height = scaled_height < 1 ? 1 : scaled_height;
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.get());
+    glViewport(0, 0, scaled_width, scaled_height);
+    // The viewport does not limit glClear, the scissor does, so a lower scale also clears less
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(0, 0, scaled_width, scaled_height);
+}
+
+void RENDER_TARGET::blit_to_screen(int screen_width, int screen_height) {
+    // The scissor would also cut the blit
+    glDisable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer.get());
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    // Linear filtering is the whole upscale, nothing to do at full scale but a copy
+    GLenum filter = scaled_width == screen_width && scaled_height == screen_height ? GL_NEAREST : GL_LINEAR;
+    glBlitFramebuffer(0, 0, scaled_width, scaled_height, 0, 0, screen_width, screen_height, GL_COLOR_BUFFER_BIT, filter);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, screen_width, screen_height);
+}
+
+int RENDER_TARGET::get_width() {
+    return width;
+}
+
+int RENDER_TARGET::get_height() {
+    return height;
+}
@@ -0,0 +1,32 @@
+#ifndef RENDER_TARGET_H
+#define RENDER_TARGET_H
+
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+#include "gl_handles.hpp"
+
+// Offscreen color and depth at the full window size. A lower render scale only shrinks
+// the viewport inside it, so changing the scale never reallocates anything,
+// only a window resize does. bind also scissors to the scaled size until blit_to_screen
+// stretches the used part over the window.
+class RENDER_TARGET {
+    public:
+        RENDER_TARGET(int width, int height);
+        void resize(int width, int height);
+        void bind(float scale);
+        void blit_to_screen(int screen_width, int screen_height);
+        int get_width();
+        int get_height();
+
+    private:
+        GPU_FRAMEBUFFER framebuffer;
+        GPU_RENDERBUFFER color;
+        GPU_RENDERBUFFER depth;
+        int width;
+        int height;
+        int scaled_width;
+        int scaled_height;
+};
+
+#endif
@@ -0,0 +1,80 @@
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+#include "../utils/shaders.hpp"
+#include "../utils/log.hpp"
+#include "shader_cache.hpp"
+
+#include <assert.h>
+
+static SHADER_CACHE* shader_cache = NULL;
+
+static const char* feature_names[] = {
+    "INSTANCED_TRANSFORM",
+    "UNIFORM_COLOR",
+    "SDF_ALPHA",
+};
+
+vector<string> get_shader_feature_defines(unsigned int features) {
+    vector<string> defines;
+    for (unsigned int i = 0; i < sizeof(feature_names) / sizeof(feature_names[0]); i++) {
+        if (features & (1u << i)) {
+            defines.push_back(feature_names[i]);
+        }
+    }
+    return defines;
+}
+
+GLuint SHADER_CACHE::get_program(const char* vertex_shader, const char* fragment_shader, unsigned int features) {
+    string key = string(vertex_shader) + "|" + fragment_shader + "|" + to_string(features);
+    unordered_map<string, shader_variant>::iterator found = programs.find(key);
+    if (found != programs.end()) {
+        return found->second.program.get();
+    }
+
+    GLuint program = create_shaders_from_files(vertex_shader, fragment_shader, get_shader_feature_defines(features));
+    if (!program) {
+        gl_log("ERROR: shader variant %s + %s (features 0x%x) not compiled\n", vertex_shader, fragment_shader, features);
+        return 0;
+    }
+    gl_log("compiled shader variant %s + %s (features 0x%x)\n", vertex_shader, fragment_shader, features);
+    shader_variant& variant = programs[key];
+    variant.vertex_shader = vertex_shader;
+    variant.fragment_shader = fragment_shader;
+    variant.features = features;
+    variant.program = GPU_PROGRAM(program);
+    return program;
+}
+
+void SHADER_CACHE::reload() {
+    unsigned int n_reloaded = 0;
+    for (unordered_map<string, shader_variant>::iterator it = programs.begin(); it != programs.end(); it++) {
+        shader_variant& variant = it->second;
+        if (reload_shader_from_files(variant.program.get(), variant.vertex_shader.c_str(),
+            variant.fragment_shader.c_str(), get_shader_feature_defines(variant.features))) {
+                n_reloaded++;
+        } else {
+            gl_log("ERROR: shader variant %s + %s (features 0x%x) not reloaded\n",
+                variant.vertex_shader.c_str(), variant.fragment_shader.c_str(), variant.features);
+        }
+    }
+    gl_log("reloaded %u of %u shader variants\n", n_reloaded, (unsigned int)programs.size());
+}
+
+unsigned int SHADER_CACHE::get_variant_count() {
+    return programs.size();
+}
+
+void set_shader_cache(SHADER_CACHE* cache) {
+    shader_cache = cache;
+}
+
+GLuint get_shader_program(const char* vertex_shader, const char* fragment_shader, unsigned int features) {
+    assert(shader_cache);
+    return shader_cache->get_program(vertex_shader, fragment_shader, features);
+}
+
+void reload_shader_programs() {
+    assert(shader_cache);
+    shader_cache->reload();
+}
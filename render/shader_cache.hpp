@@ -0,0 +1,50 @@
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+#include "gl_handles.hpp"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+using namespace std;
+
+// Features a shader variant is compiled for, each one is a define of the same name
+// without the SHADER_ prefix. The shaders pick their code with #ifdef, so a variant
+// has no branches left for features it does not use.
+enum shader_feature {
+    SHADER_INSTANCED_TRANSFORM = 1 << 0, // mat4 attribute per draw instead of the transform uniform
+    SHADER_UNIFORM_COLOR = 1 << 1,       // object_color uniform instead of a color per vertex
+    SHADER_SDF_ALPHA = 1 << 2,           // Texture alpha is a distance field, edges are antialiased
+};
+
+vector<string> get_shader_feature_defines(unsigned int features);
+
+// Every combination of files and features is compiled on first use and kept,
+// renderers ask for their variant once and can share the same program.
+// reload links every variant again from its files and features, the program names stay the same.
+class SHADER_CACHE {
+    public:
+        GLuint get_program(const char* vertex_shader, const char* fragment_shader, unsigned int features);
+        void reload();
+        unsigned int get_variant_count();
+
+    private:
+        struct shader_variant {
+            string vertex_shader;
+            string fragment_shader;
+            unsigned int features;
+            GPU_PROGRAM program;
+        };
+
+        unordered_map<string, shader_variant> programs;
+};
+
+// Renderers get their programs through the cache set here, it has to outlive them
+void set_shader_cache(SHADER_CACHE* cache);
+GLuint get_shader_program(const char* vertex_shader, const char* fragment_shader, unsigned int features);
+void reload_shader_programs();
+
+#endif
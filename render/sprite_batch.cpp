@@ -0,0 +1,129 @@
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+#include "../utils/log.hpp"
+#include "../shapes/mesh_optimizer.hpp"
+#include "shader_cache.hpp"
+#include "sprite_batch.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+
+SPRITE_BATCH::SPRITE_BATCH(unsigned int max_sprites, unsigned int shader_features)
+    : vertex_heap(GPU_MEMORY_VERTEX, GL_STREAM_DRAW, 1, sizeof(sprite_vertex), max_sprites * 4),
+      index_heap(GPU_MEMORY_INDEX, GL_STATIC_DRAW, 1, choose_index_size(max_sprites * 4), max_sprites * 6) {
+    this->max_sprites = max_sprites;
+    atlas = NULL;
+    vertex_offset = vertex_heap.allocate(max_sprites * 4);
+    index_offset = index_heap.allocate(max_sprites * 6);
+
+    // Every quad is two triangles over its 4 vertices, the same for all of them so only written once
+    vector<unsigned int> indices(max_sprites * 6);
+    for (unsigned int i = 0; i < max_sprites; i++) {
+        unsigned int first = vertex_offset + i * 4;
+        unsigned int quad[6] = {first, first + 1, first + 2, first, first + 2, first + 3};
+        for (int j = 0; j < 6; j++) {
+            indices[i * 6 + j] = quad[j];
+        }
+    }
+    if (choose_index_size(max_sprites * 4) == 2) {
+        vector<uint16_t> short_indices(indices.size());
+        narrow_indices(indices.data(), indices.size(), short_indices.data());
+        index_heap.write(0, index_offset, short_indices.size(), short_indices.data());
+        index_type = GL_UNSIGNED_SHORT;
+    } else {
+        index_heap.write(0, index_offset, indices.size(), indices.data());
+        index_type = GL_UNSIGNED_INT;
+    }
+
+    vao = create_vertex_array();
+    glBindVertexArray(vao.get());
+    glBindBuffer(GL_ARRAY_BUFFER, vertex_heap.get_buffer(0));
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(sprite_vertex), (void*)offsetof(sprite_vertex, x));
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(sprite_vertex), (void*)offsetof(sprite_vertex, u));
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(sprite_vertex), (void*)offsetof(sprite_vertex, r));
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_heap.get_buffer(0));
+    glBindVertexArray(0);
+
+    texture = create_texture();
+    shader_programme = get_shader_program("sprite_vs.glsl", "sprite_fs.glsl", shader_features);
+    glUseProgram(shader_programme);
+    glUniform1i(glGetUniformLocation(shader_programme, "atlas"), 0);
+    glUseProgram(0);
+}
+
+void SPRITE_BATCH::set_atlas(TEXTURE_ATLAS* atlas) {
+    this->atlas = atlas;
+    upload_atlas();
+}
+
+void SPRITE_BATCH::upload_atlas() {
+    const image& page = atlas->get_page();
+    glBindTexture(GL_TEXTURE_2D, texture.get());
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, page.width, page.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, page.pixels.data());
+    // Mips below the padded level would mix neighbouring sprites
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, atlas->get_mip_levels());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    atlas->clear_dirty();
+}
+
+void SPRITE_BATCH::add(int sprite, float x, float y, float width, float height, float r, float g, float b, float a) {
+    add_quad(atlas->get_uv(sprite), x, y, width, height, r, g, b, a);
+}
+
+void SPRITE_BATCH::add_quad(const atlas_uv& uv, float x, float y, float width, float height,
+    float r, float g, float b, float a) {
+        if (vertices.size() / 4 >= max_sprites) {
+            return;
+        }
+        // x, y is the top left corner, y points up
+        sprite_vertex quad[4] = {
+            {x, y, uv.u0, uv.v0, r, g, b, a},
+            {x + width, y, uv.u1, uv.v0, r, g, b, a},
+            {x + width, y - height, uv.u1, uv.v1, r, g, b, a},
+            {x, y - height, uv.u0, uv.v1, r, g, b, a},
+        };
+        vertices.insert(vertices.end(), quad, quad + 4);
+}
+
+void SPRITE_BATCH::update_texture() {
+    if (atlas && atlas->is_dirty()) {
+        upload_atlas();
+    }
+}
+
+// No GL calls, the vertices are uploaded by the packet when the queue is submitted
+void SPRITE_BATCH::record(RENDER_LIST& list, render_layer layer) {
+    recorded.swap(vertices);
+    vertices.clear();
+    if (recorded.empty() || !atlas) {
+        return;
+    }
+
+    draw_packet packet = {};
+    // Sprites go over the scene in the order they were added
+    packet.key = make_sort_key(layer, shader_programme, vao.get(), 0.0f, true);
+    packet.program = shader_programme;
+    packet.vao = vao.get();
+    packet.texture = texture.get();
+    packet.blend = true;
+    packet.mode = GL_TRIANGLES;
+    packet.index_type = index_type;
+    // All sprites with one call, however many different images they show
+    packet.count = recorded.size() / 4 * 6;
+    packet.offset = index_offset * (index_type == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int));
+    packet.uploads[0].buffer = vertex_heap.get_buffer(0);
+    packet.uploads[0].offset = vertex_offset * sizeof(sprite_vertex);
+    packet.uploads[0].size = recorded.size() * sizeof(sprite_vertex);
+    packet.uploads[0].data = recorded.data();
+    packet.n_uploads = 1;
+    list.add(packet);
+}
@@ -0,0 +1,52 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+#include "../utils/texture_atlas.hpp"
+#include "gl_handles.hpp"
+#include "gpu_heap.hpp"
+#include "render_queue.hpp"
+
+#include <vector>
+using namespace std;
+
+struct sprite_vertex {
+    float x, y;
+    float u, v;
+    float r, g, b, a;
+};
+
+// Textured quads out of one atlas, collected during the frame and drawn with a single call.
+// The atlas page is uploaded again (with mipmaps) by update_texture when images were added to it.
+// shader_features picks the shader variant (SHADER_SDF_ALPHA for distance field text).
+class SPRITE_BATCH {
+    public:
+        SPRITE_BATCH(unsigned int max_sprites, unsigned int shader_features);
+        void set_atlas(TEXTURE_ATLAS* atlas);
+        void add(int sprite, float x, float y, float width, float height,
+            float r = 1.0f, float g = 1.0f, float b = 1.0f, float a = 1.0f);
+        void add_quad(const atlas_uv& uv, float x, float y, float width, float height,
+            float r, float g, float b, float a);
+        void update_texture();
+        void record(RENDER_LIST& list, render_layer layer);
+
+    private:
+        unsigned int max_sprites;
+        TEXTURE_ATLAS* atlas;
+        GPU_HEAP vertex_heap;
+        GPU_HEAP index_heap;
+        size_t vertex_offset;
+        size_t index_offset;
+        GLenum index_type;
+        GPU_VERTEX_ARRAY vao;
+        GLuint shader_programme; // Owned by the shader cache
+        GPU_TEXTURE texture;
+        vector<sprite_vertex> vertices;
+        vector<sprite_vertex> recorded; // Read by the packet until the queue is submitted
+
+        void upload_atlas();
+};
+
+#endif
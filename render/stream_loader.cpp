@@ -0,0 +1,299 @@
+#include "stream_loader.hpp"
+#include "../utils/log.hpp"
+#include "../shapes/mesh_optimizer.hpp"
+#include "../shapes/simplify.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+// Decoded chunks waiting for upload, the reader blocks when it gets this far ahead
+#define MAX_READY_CHUNKS 16
+// Smallest page size of the platforms we run on
+#define PREFAULT_STRIDE 4096
+
+STREAM_LOADER::STREAM_LOADER(MESH_POOL* mesh_pool, SPATIAL_GRID* spatial_grid, JOB_SYSTEM* job_system) {
+    this->mesh_pool = mesh_pool;
+    this->spatial_grid = spatial_grid;
+    this->job_system = job_system;
+    worker_done = true;
+    cancelled = false;
+}
+
+STREAM_LOADER::~STREAM_LOADER() {
+    stop_reader();
+}
+
+// Cancels the reader and drops whatever it has queued, afterwards the loader can start again
+void STREAM_LOADER::stop_reader() {
+    // Set under the lock, otherwise the reader can check the condition, miss the notify and wait forever
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        cancelled = true;
+        ready_chunks.clear();
+    }
+    queue_space.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+    cancelled = false;
+}
+
+// Mesh ids and pool space of the removed blocks are reused by the next load
+void STREAM_LOADER::unload() {
+    stop_reader();
+    for (int first_mesh : uploaded_blocks) {
+        mesh_pool->remove_mesh_block(first_mesh, spatial_grid);
+    }
+    uploaded_blocks.clear();
+}
+
+void STREAM_LOADER::load_scene(const char* path, unsigned int shapes_per_chunk) {
+    start(&STREAM_LOADER::read_scene, path, shapes_per_chunk);
+}
+
+void STREAM_LOADER::load_polygons(const char* path, unsigned int shapes_per_chunk) {
+    start(&STREAM_LOADER::read_polygons, path, shapes_per_chunk);
+}
+
+void STREAM_LOADER::start(void (STREAM_LOADER::*read)(string, unsigned int), const char* path, unsigned int shapes_per_chunk) {
+    // One load at a time, wait for the previous reader to finish
+    if (worker.joinable()) {
+        worker.join();
+    }
+    worker_done = false;
+    worker = thread(read, this, string(path), shapes_per_chunk);
+}
+
+void STREAM_LOADER::pump(double budget_seconds) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    while (true) {
+        stream_chunk chunk;
+        {
+            lock_guard<mutex> lock(queue_mutex);
+            if (ready_chunks.empty()) {
+                return;
+            }
+            chunk = std::move(ready_chunks.front());
+            ready_chunks.pop_front();
+        }
+        queue_space.notify_one();
+        upload_chunk(chunk);
+
+        // Always upload at least one chunk per frame so loading makes progress
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (elapsed >= budget_seconds) {
+            return;
+        }
+    }
+}
+
+bool STREAM_LOADER::is_done() {
+    if (!worker_done) {
+        return false;
+    }
+    lock_guard<mutex> lock(queue_mutex);
+    return ready_chunks.empty();
+}
+
+// Reads one byte per page, so the render thread finds the chunk in memory instead of waiting on the disk
+static void prefault(const void* data, size_t size) {
+    const volatile char* bytes = (const volatile char*)data;
+    for (size_t offset = 0; offset < size; offset += PREFAULT_STRIDE) {
+        (void)bytes[offset];
+    }
+}
+
+void STREAM_LOADER::read_scene(string path, unsigned int shapes_per_chunk) {
+    // Shared with the chunks, the file is unmapped after the last of them is uploaded
+    shared_ptr<SCENE_FILE> scene = make_shared<SCENE_FILE>();
+    if (!scene->open(path.c_str())) {
+        worker_done = true;
+        return;
+    }
+    size_t positions_size, colors_size, n_indices, shapes_size;
+    unsigned int index_size;
+    const float* positions = (const float*)scene->get_section(SCENE_SECTION_POSITIONS, &positions_size);
+    const float* colors = (const float*)scene->get_section(SCENE_SECTION_COLORS, &colors_size);
+    const void* indices = scene->get_indices(&n_indices, &index_size);
+    const scene_shape_record* shapes = (const scene_shape_record*)scene->get_section(SCENE_SECTION_SHAPES, &shapes_size);
+    // Levels are relative to their shape, so they are copied as they are
+    size_t lods_size;
+    const scene_shape_lods* lods = (const scene_shape_lods*)scene->get_section(SCENE_SECTION_LODS, &lods_size);
+    if (!positions || !colors || !indices || !shapes) {
+        gl_log("ERROR: scene file %s is missing geometry sections\n", path.c_str());
+        worker_done = true;
+        return;
+    }
+
+    // The converter stores shapes back to back, so a run of shapes is one contiguous range
+    // per section. Chunks point into the mapping, the pool copies straight from the file.
+    // The range is taken over every record of the run, so records out of order cannot make
+    // the offsets below wrap around (open already checked that they stay inside the sections).
+    unsigned int n_shapes = shapes_size / sizeof(scene_shape_record);
+    for (unsigned int first = 0; first < n_shapes && !cancelled; first += shapes_per_chunk) {
+        unsigned int last = min(first + shapes_per_chunk, n_shapes) - 1;
+        unsigned int first_vertex = shapes[first].base_vertex;
+        unsigned int end_vertex = first_vertex;
+        unsigned int first_index = shapes[first].first_index;
+        unsigned int end_index = first_index;
+        for (unsigned int i = first; i <= last; i++) {
+            first_vertex = min(first_vertex, (unsigned int)shapes[i].base_vertex);
+            end_vertex = max(end_vertex, shapes[i].base_vertex + shapes[i].vertex_count);
+            first_index = min(first_index, shapes[i].first_index);
+            end_index = max(end_index, shapes[i].first_index + shapes[i].index_count);
+        }
+
+        stream_chunk chunk;
+        chunk.scene = scene;
+        chunk.mapped_positions = positions + 3 * first_vertex;
+        chunk.mapped_colors = colors + 3 * first_vertex;
+        chunk.mapped_indices = (const char*)indices + (size_t)first_index * index_size;
+        chunk.mapped_index_size = index_size;
+        chunk.n_mapped_vertices = end_vertex - first_vertex;
+        chunk.n_mapped_indices = end_index - first_index;
+        prefault(chunk.mapped_positions, chunk.n_mapped_vertices * 3 * sizeof(float));
+        prefault(chunk.mapped_colors, chunk.n_mapped_vertices * 3 * sizeof(float));
+        prefault(chunk.mapped_indices, (size_t)chunk.n_mapped_indices * index_size);
+        for (unsigned int i = first; i <= last; i++) {
+            scene_shape_record record = shapes[i];
+            record.first_index -= first_index;
+            record.base_vertex -= first_vertex;
+            chunk.shapes.push_back(record);
+            if (lods) {
+                chunk.lods.push_back(lods[i]);
+            }
+        }
+        if (!push_chunk(chunk)) {
+            break;
+        }
+    }
+    worker_done = true;
+}
+
+void STREAM_LOADER::read_polygons(string path, unsigned int shapes_per_chunk) {
+    ifstream input(path);
+    if (!input) {
+        gl_log("ERROR: could not open polygon file %s\n", path.c_str());
+        worker_done = true;
+        return;
+    }
+
+    // Same text format as tools/scene_converter, triangulated here instead of offline
+    vector<polygon_source> batch;
+    string line;
+    while (!cancelled && getline(input, line)) {
+        line = line.substr(0, line.find('#'));
+        stringstream values(line);
+        polygon_source polygon;
+        if (!(values >> polygon.r >> polygon.g >> polygon.b)) {
+            continue;
+        }
+        float x, y;
+        while (values >> x >> y) {
+            polygon.vertices.push_back(x);
+            polygon.vertices.push_back(y);
+            polygon.vertices.push_back(0.0f);
+        }
+        batch.push_back(polygon);
+
+        if (batch.size() >= shapes_per_chunk) {
+            stream_chunk chunk;
+            decode_polygons(batch, chunk);
+            batch.clear();
+            if (!push_chunk(chunk)) {
+                break;
+            }
+        }
+    }
+    if (!batch.empty() && !cancelled) {
+        stream_chunk chunk;
+        decode_polygons(batch, chunk);
+        push_chunk(chunk);
+    }
+    worker_done = true;
+}
+
+void STREAM_LOADER::decode_polygons(const vector<polygon_source>& batch, stream_chunk& chunk) {
+    // Triangulating and simplifying is the expensive part, spread it over the job system when there is one
+    vector<mesh_data> meshes(batch.size());
+    function<void(unsigned int, unsigned int)> decode = [&](unsigned int first, unsigned int last) {
+        for (unsigned int i = first; i < last; i++) {
+            const polygon_source& polygon = batch[i];
+            meshes[i] = make_polygon_lod_mesh(polygon.vertices.data(), polygon.vertices.size() / 3, polygon.r, polygon.g, polygon.b);
+            if (!meshes[i].indices.empty()) {
+                optimize_mesh(meshes[i]);
+            }
+        }
+    };
+    if (job_system) {
+        job_system->parallel_for(0, batch.size(), 4, decode);
+    } else {
+        decode(0, batch.size());
+    }
+
+    for (const mesh_data& mesh : meshes) {
+        scene_shape_lods lods;
+        if (mesh.indices.empty() || !make_scene_lods(mesh, lods)) {
+            continue;
+        }
+        chunk.lods.push_back(lods);
+        aabb bounds = get_mesh_bounds(mesh);
+        scene_shape_record record;
+        record.first_index = chunk.indices.size();
+        record.index_count = mesh.indices.size();
+        record.base_vertex = chunk.positions.size() / 3;
+        record.vertex_count = mesh.positions.size() / 3;
+        record.bounds[0] = bounds.min_x;
+        record.bounds[1] = bounds.min_y;
+        record.bounds[2] = bounds.max_x;
+        record.bounds[3] = bounds.max_y;
+        chunk.shapes.push_back(record);
+        chunk.positions.insert(chunk.positions.end(), mesh.positions.begin(), mesh.positions.end());
+        chunk.colors.insert(chunk.colors.end(), mesh.colors.begin(), mesh.colors.end());
+        chunk.indices.insert(chunk.indices.end(), mesh.indices.begin(), mesh.indices.end());
+    }
+}
+
+bool STREAM_LOADER::push_chunk(stream_chunk& chunk) {
+    unique_lock<mutex> lock(queue_mutex);
+    queue_space.wait(lock, [this] { return cancelled || ready_chunks.size() < MAX_READY_CHUNKS; });
+    if (cancelled) {
+        return false;
+    }
+    ready_chunks.push_back(std::move(chunk));
+    return true;
+}
+
+void STREAM_LOADER::upload_chunk(stream_chunk& chunk) {
+    // When no polygon of a batch triangulates there is nothing to add
+    if (chunk.shapes.empty()) {
+        return;
+    }
+    const scene_shape_lods* lods = chunk.lods.empty() ? NULL : chunk.lods.data();
+    int first_mesh;
+    if (chunk.scene) {
+        first_mesh = mesh_pool->add_mesh_block(
+            chunk.mapped_positions, chunk.mapped_colors, chunk.n_mapped_vertices,
+            chunk.mapped_indices, chunk.mapped_index_size, chunk.n_mapped_indices,
+            chunk.shapes.data(), chunk.shapes.size(), lods);
+    } else {
+        first_mesh = mesh_pool->add_mesh_block(
+            chunk.positions.data(), chunk.colors.data(), chunk.positions.size() / 3,
+            chunk.indices.data(), sizeof(unsigned int), chunk.indices.size(),
+            chunk.shapes.data(), chunk.shapes.size(), lods);
+    }
+    if (first_mesh < 0) {
+        return;
+    }
+    uploaded_blocks.push_back(first_mesh);
+    if (!spatial_grid) {
+        return;
+    }
+    // Visible from the next cull on
+    for (size_t i = 0; i < chunk.shapes.size(); i++) {
+        const float* bounds = chunk.shapes[i].bounds;
+        aabb box = {bounds[0], bounds[1], bounds[2], bounds[3]};
+        spatial_grid->insert(first_mesh + i, box);
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef STREAM_LOADER_H
+#define STREAM_LOADER_H
+
+#include "../utils/scene_file.hpp"
+#include "../utils/spatial_grid.hpp"
+#include "../utils/job_system.hpp"
+#include "mesh_pool.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// One polygon as read from a text polygon list
+struct polygon_source {
+    vector<float> vertices;
+    float r;
+    float g;
+    float b;
+};
+
+// A few shapes worth of geometry, ready to be copied into the mesh pool.
+// Decoded polygons own their geometry, scene chunks point into the mapped file,
+// which stays mapped as long as a chunk holds on to it.
+struct stream_chunk {
+    vector<float> positions;
+    vector<float> colors;
+    vector<unsigned int> indices;
+    shared_ptr<SCENE_FILE> scene;
+    const float* mapped_positions;
+    const float* mapped_colors;
+    const void* mapped_indices;
+    unsigned int mapped_index_size;
+    unsigned int n_mapped_vertices;
+    unsigned int n_mapped_indices;
+    vector<scene_shape_record> shapes; // Offsets relative to this chunk
+    vector<scene_shape_lods> lods; // One per shape, empty when every shape is a single level
+};
+
+// Reads and decodes geometry on a background thread while the render thread
+// uploads the finished chunks a few at a time, so big scenes load without
+// stalling the game loop. Shapes are added to the grid as they arrive.
+// unload takes everything loaded so far out of the pool and the grid again.
+class STREAM_LOADER {
+    public:
+        STREAM_LOADER(MESH_POOL* mesh_pool, SPATIAL_GRID* spatial_grid, JOB_SYSTEM* job_system);
+        ~STREAM_LOADER();
+        void load_scene(const char* path, unsigned int shapes_per_chunk);
+        void load_polygons(const char* path, unsigned int shapes_per_chunk);
+        void pump(double budget_seconds);
+        void unload();
+        bool is_done();
+
+    private:
+        MESH_POOL* mesh_pool;
+        SPATIAL_GRID* spatial_grid;
+        JOB_SYSTEM* job_system;
+        thread worker;
+        mutex queue_mutex;
+        condition_variable queue_space;
+        deque<stream_chunk> ready_chunks;
+        atomic<bool> worker_done;
+        atomic<bool> cancelled;
+        vector<int> uploaded_blocks; // First mesh id of every block in the pool
+
+        void stop_reader();
+        void start(void (STREAM_LOADER::*read)(string, unsigned int), const char* path, unsigned int shapes_per_chunk);
+        void read_scene(string path, unsigned int shapes_per_chunk);
+        void read_polygons(string path, unsigned int shapes_per_chunk);
+        void decode_polygons(const vector<polygon_source>& batch, stream_chunk& chunk);
+        bool push_chunk(stream_chunk& chunk);
+        void upload_chunk(stream_chunk& chunk);
+};
+
+#endif
@@ -0,0 +1,49 @@
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+#include "shader_cache.hpp"
+#include "text_renderer.hpp"
+
+TEXT_RENDERER::TEXT_RENDERER(unsigned int max_glyphs, const char* cache_path)
+    : atlas(512, 512, 1), font(&atlas, cache_path), batch(max_glyphs, SHADER_SDF_ALPHA) {
+    batch.set_atlas(&atlas);
+    viewport_width = 800;
+    viewport_height = 800;
+}
+
+void TEXT_RENDERER::set_viewport(int width, int height) {
+    viewport_width = width;
+    viewport_height = height;
+}
+
+// x, y is the top left of the first line in window pixels, pixel_size is how big a font pixel is on screen
+void TEXT_RENDERER::add_text(const char* text, float x, float y, float pixel_size, float r, float g, float b, float a) {
+    // Quads cover the whole cell, the field around the glyph included
+    float scale_x = 2.0f / viewport_width;
+    float scale_y = 2.0f / viewport_height;
+    float border = (float)SDF_SPREAD / SDF_CELL_SCALE * pixel_size;
+    float quad_width = (float)SDF_CELL_WIDTH / SDF_CELL_SCALE * pixel_size;
+    float quad_height = (float)SDF_CELL_HEIGHT / SDF_CELL_SCALE * pixel_size;
+    float advance = (SDF_FONT_WIDTH + 1) * pixel_size;
+    float line_height = (SDF_FONT_HEIGHT + 2) * pixel_size;
+
+    float pen_x = x;
+    float pen_y = y;
+    for (const char* c = text; *c; c++) {
+        if (*c == '\n') {
+            pen_x = x;
+            pen_y += line_height;
+            continue;
+        }
+        if (*c != ' ') {
+            batch.add(font.get_sprite(*c),
+                (pen_x - border) * scale_x - 1.0f, 1.0f - (pen_y - border) * scale_y,
+                quad_width * scale_x, quad_height * scale_y, r, g, b, a);
+        }
+        pen_x += advance;
+    }
+}
+
+void TEXT_RENDERER::record(RENDER_LIST& list) {
+    batch.record(list, RENDER_LAYER_OVERLAY);
+}
@@ -0,0 +1,29 @@
+#ifndef TEXT_RENDERER_H
+#define TEXT_RENDERER_H
+
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+#include "../utils/texture_atlas.hpp"
+#include "../utils/sdf_font.hpp"
+#include "sprite_batch.hpp"
+
+// Lays strings out as glyph quads into a sprite batch, all text of a frame is one draw call.
+// The glyphs are distance fields, so the same atlas stays sharp at any text size.
+class TEXT_RENDERER {
+    public:
+        TEXT_RENDERER(unsigned int max_glyphs, const char* cache_path);
+        void set_viewport(int width, int height);
+        void add_text(const char* text, float x, float y, float pixel_size,
+            float r = 1.0f, float g = 1.0f, float b = 1.0f, float a = 1.0f);
+        void record(RENDER_LIST& list);
+
+    private:
+        TEXTURE_ATLAS atlas;
+        SDF_FONT font;
+        SPRITE_BATCH batch;
+        int viewport_width;
+        int viewport_height;
+};
+
+#endif
@@ -0,0 +1,5 @@
+// Distance field with 0.5 at the edge, smoothed over about one screen pixel
+float sdf_coverage(float distance) {
+    float width = fwidth(distance);
+    return smoothstep(0.5f - width, 0.5f + width, distance);
+}
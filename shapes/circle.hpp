@@ -5,20 +5,20 @@
 #include <GLFW/glfw3.h>
 #include "../glm/glm.hpp"
 
+#include "../render/gl_handles.hpp"
 #include "shape.hpp"
 
 class CIRCLE: public SHAPE {
     public:
         CIRCLE(float x_center, float y_center, float radius, int n_sides);
         void draw();
-        void delete_buffers();
 
     private:
-        GLuint points_vbo;
-        GLuint color_vbo;
-        GLuint ebo;
-        GLuint vao;
-        GLuint shader_programme;
+        GPU_BUFFER points_vbo;
+        GPU_BUFFER ebo;
+        GPU_VERTEX_ARRAY vao;
+        GLuint shader_programme; // Owned by the shader cache
+        glm::vec4 color;
         unsigned int n_elements;
 };
 
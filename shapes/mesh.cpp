@@ -0,0 +1,124 @@
+#include "mesh.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+mesh_data make_triangle_mesh(const float vertices[9], const float colors[9]) {
+    mesh_data mesh;
+    mesh.positions.assign(vertices, vertices + 9);
+    mesh.colors.assign(colors, colors + 9);
+    mesh.indices = {0, 1, 2};
+    return mesh;
+}
+
+mesh_data make_quad_mesh(const float vertices[12], const float colors[12]) {
+    // Vertices must be passed as Top left, Top Right, Bottom Right, Bottom left
+    mesh_data mesh;
+    mesh.positions.assign(vertices, vertices + 12);
+    mesh.colors.assign(colors, colors + 12);
+    mesh.indices = {
+        0, 1, 3,
+        1, 2, 3
+    };
+    return mesh;
+}
+
+mesh_data make_circle_mesh(float x_center, float y_center, float radius, int n_sides) {
+    mesh_data mesh;
+    float angle = 360.0 / float(n_sides) * M_PI / 180.0;
+
+    // Center vertex first, the rim vertices follow
+    mesh.positions = {x_center, y_center, 0.0f};
+    mesh.colors = {0.0f, 0.5f, 1.0f};
+    for (int i = 0; i < n_sides; i++) {
+        mesh.positions.push_back(x_center + radius * cos(i * angle));
+        mesh.positions.push_back(y_center + radius * sin(i * angle));
+        mesh.positions.push_back(0.0f);
+
+        mesh.colors.push_back(0.0f);
+        mesh.colors.push_back(0.5f);
+        mesh.colors.push_back(1.0f);
+
+        // One triangle from the center to each rim edge, wrapping at the end
+        mesh.indices.push_back(0);
+        mesh.indices.push_back(i + 1);
+        mesh.indices.push_back((i + 1) % n_sides + 1);
+    }
+    return mesh;
+}
+
+mesh_data make_polygon_mesh(
+    const float vertices[], int n_vertices, float r, float g, float b,
+    triangulation_engine engine) {
+        return make_polygon_mesh(vertices, &n_vertices, 1, r, g, b, engine);
+}
+
+mesh_data make_polygon_mesh(
+    const float vertices[], const int contour_sizes[], int n_contours, float r, float g, float b,
+    triangulation_engine engine) {
+        int n_vertices = 0;
+        for (int i = 0; i < n_contours; i++) {
+            n_vertices += contour_sizes[i];
+        }
+
+        mesh_data mesh;
+        mesh.positions.assign(vertices, vertices + 3 * n_vertices);
+        for (int i = 0; i < n_vertices; i++) {
+            mesh.colors.push_back(r);
+            mesh.colors.push_back(g);
+            mesh.colors.push_back(b);
+        }
+        // Leaves the indices empty when the polygon can not be triangulated
+        if (!triangulate_polygon(vertices, contour_sizes, n_contours, engine, mesh.indices)) {
+            mesh.indices.clear();
+        }
+        return mesh;
+}
+
+aabb get_mesh_bounds(const mesh_data& mesh) {
+    aabb bounds = {0.0f, 0.0f, 0.0f, 0.0f};
+    if (mesh.positions.empty()) {
+        return bounds;
+    }
+    bounds.min_x = bounds.max_x = mesh.positions[0];
+    bounds.min_y = bounds.max_y = mesh.positions[1];
+    for (size_t i = 3; i < mesh.positions.size(); i += 3) {
+        bounds.min_x = min(bounds.min_x, mesh.positions[i]);
+        bounds.max_x = max(bounds.max_x, mesh.positions[i]);
+        bounds.min_y = min(bounds.min_y, mesh.positions[i + 1]);
+        bounds.max_y = max(bounds.max_y, mesh.positions[i + 1]);
+    }
+    return bounds;
+}
+
+unsigned int get_mesh_lod_count(const mesh_data& mesh) {
+    return mesh.lods.empty() ? 1 : mesh.lods.size();
+}
+
+mesh_data get_mesh_lod(const mesh_data& mesh, unsigned int level) {
+    if (mesh.lods.empty()) {
+        return mesh;
+    }
+    const mesh_lod& lod = mesh.lods[level];
+    mesh_data result;
+    result.positions.assign(mesh.positions.begin() + 3 * lod.first_vertex,
+        mesh.positions.begin() + 3 * (lod.first_vertex + lod.vertex_count));
+    result.colors.assign(mesh.colors.begin() + 3 * lod.first_vertex,
+        mesh.colors.begin() + 3 * (lod.first_vertex + lod.vertex_count));
+    result.indices.assign(mesh.indices.begin() + lod.first_index,
+        mesh.indices.begin() + lod.first_index + lod.index_count);
+    return result;
+}
+
+void add_mesh_lod(mesh_data& mesh, const mesh_data& level, float error) {
+    mesh_lod lod;
+    lod.first_index = mesh.indices.size();
+    lod.index_count = level.indices.size();
+    lod.first_vertex = mesh.positions.size() / 3;
+    lod.vertex_count = level.positions.size() / 3;
+    lod.error = error;
+    mesh.lods.push_back(lod);
+    mesh.positions.insert(mesh.positions.end(), level.positions.begin(), level.positions.end());
+    mesh.colors.insert(mesh.colors.end(), level.colors.begin(), level.colors.end());
+    mesh.indices.insert(mesh.indices.end(), level.indices.begin(), level.indices.end());
+}
@@ -0,0 +1,46 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include "../utils/aabb.hpp"
+#include "triangulate.hpp"
+
+#include <vector>
+using namespace std;
+
+// One level of detail of a mesh. Levels are stored one after another, each with its own
+// vertices, offsets are relative to the start of the mesh and indices to the level's first vertex.
+struct mesh_lod {
+    unsigned int first_index;
+    unsigned int index_count;
+    unsigned int first_vertex;
+    unsigned int vertex_count;
+    float error; // Largest distance from the full outline, 0 for level 0
+};
+
+// CPU side geometry of a single shape, indices are always a plain triangle list
+// (no fans or strips) so every mesh can share one draw call in the mesh pool
+struct mesh_data {
+    vector<float> positions; // x, y, z per vertex
+    vector<float> colors; // r, g, b per vertex
+    vector<unsigned int> indices;
+    vector<mesh_lod> lods; // Finest first, empty when the whole mesh is the only level
+};
+
+mesh_data make_triangle_mesh(const float vertices[9], const float colors[9]);
+mesh_data make_quad_mesh(const float vertices[12], const float colors[12]);
+mesh_data make_circle_mesh(float x_center, float y_center, float radius, int n_sides);
+mesh_data make_polygon_mesh(
+    const float vertices[], int n_vertices, float r, float g, float b,
+    triangulation_engine engine = TRIANGULATE_EAR_CLIPPING);
+mesh_data make_polygon_mesh(
+    const float vertices[], const int contour_sizes[], int n_contours, float r, float g, float b,
+    triangulation_engine engine);
+aabb get_mesh_bounds(const mesh_data& mesh);
+
+// Levels of detail as separate meshes, a mesh without levels is its own level 0
+unsigned int get_mesh_lod_count(const mesh_data& mesh);
+mesh_data get_mesh_lod(const mesh_data& mesh, unsigned int level);
+// Appends a single level mesh as the next level, the mesh has to be empty or made of levels
+void add_mesh_lod(mesh_data& mesh, const mesh_data& level, float error);
+
+#endif
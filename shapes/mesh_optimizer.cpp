@@ -0,0 +1,232 @@
+#include "mesh_optimizer.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+// Scoring constants from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+#define CACHE_DECAY_POWER 1.5f
+#define LAST_TRIANGLE_SCORE 0.75f
+#define VALENCE_BOOST_SCALE 2.0f
+#define VALENCE_BOOST_POWER 0.5f
+
+float compute_acmr(const vector<unsigned int>& indices, unsigned int n_vertices, unsigned int cache_size) {
+    if (indices.size() < 3) {
+        return 0.0f;
+    }
+
+    // Time stamp of when each vertex entered the FIFO, a vertex is cached when it
+    // entered less than cache_size misses ago
+    vector<unsigned int> entered(n_vertices, 0);
+    unsigned int misses = 0;
+    for (unsigned int index : indices) {
+        if (entered[index] == 0 || misses - entered[index] + 1 > cache_size) {
+            misses++;
+            entered[index] = misses;
+        }
+    }
+    return (float)misses / (indices.size() / 3);
+}
+
+static float get_vertex_score(int cache_position, unsigned int remaining_triangles) {
+    if (remaining_triangles == 0) {
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+    if (cache_position >= 0) {
+        if (cache_position < 3) {
+            // Used by the last triangle, these are hits no matter what is picked
+            score = LAST_TRIANGLE_SCORE;
+        } else {
+            float scaler = 1.0f / (VERTEX_CACHE_SIZE - 3);
+            score = pow(1.0f - (cache_position - 3) * scaler, CACHE_DECAY_POWER);
+        }
+    }
+
+    // Prefer finishing off vertices with only a few triangles left
+    score += VALENCE_BOOST_SCALE * pow((float)remaining_triangles, -VALENCE_BOOST_POWER);
+    return score;
+}
+
+void optimize_vertex_cache(vector<unsigned int>& indices, unsigned int n_vertices) {
+    unsigned int n_triangles = indices.size() / 3;
+    if (n_triangles < 2) {
+        return;
+    }
+
+    // Triangle adjacency per vertex, flattened
+    vector<unsigned int> remaining(n_vertices, 0);
+    for (unsigned int index : indices) {
+        remaining[index]++;
+    }
+    vector<unsigned int> adjacency_offset(n_vertices + 1, 0);
+    for (unsigned int i = 0; i < n_vertices; i++) {
+        adjacency_offset[i + 1] = adjacency_offset[i] + remaining[i];
+    }
+    vector<unsigned int> adjacency(indices.size());
+    vector<unsigned int> fill(adjacency_offset.begin(), adjacency_offset.end() - 1);
+    for (unsigned int i = 0; i < indices.size(); i++) {
+        adjacency[fill[indices[i]]++] = i / 3;
+    }
+
+    vector<int> cache_position(n_vertices, -1);
+    vector<float> vertex_score(n_vertices);
+    for (unsigned int i = 0; i < n_vertices; i++) {
+        vertex_score[i] = get_vertex_score(-1, remaining[i]);
+    }
+    vector<float> triangle_score(n_triangles);
+    vector<bool> emitted(n_triangles, false);
+    for (unsigned int t = 0; t < n_triangles; t++) {
+        triangle_score[t] = vertex_score[indices[3 * t]] + vertex_score[indices[3 * t + 1]] + vertex_score[indices[3 * t + 2]];
+    }
+
+    vector<unsigned int> result;
+    result.reserve(indices.size());
+    // The cache holds 3 extra entries while a triangle is being pushed
+    vector<unsigned int> cache;
+    vector<unsigned int> new_cache;
+    unsigned int next_unemitted = 0;
+
+    int best_triangle = -1;
+    float best_score = -1.0f;
+    for (unsigned int t = 0; t < n_triangles; t++) {
+        if (triangle_score[t] > best_score) {
+            best_score = triangle_score[t];
+            best_triangle = t;
+        }
+    }
+
+    while (best_triangle >= 0) {
+        emitted[best_triangle] = true;
+        new_cache.clear();
+        for (int k = 0; k < 3; k++) {
+            unsigned int vertex = indices[3 * best_triangle + k];
+            result.push_back(vertex);
+            new_cache.push_back(vertex);
+
+            // Drop the triangle from the vertex adjacency
+            unsigned int begin = adjacency_offset[vertex];
+            unsigned int end = begin + remaining[vertex];
+            for (unsigned int a = begin; a < end; a++) {
+                if (adjacency[a] == (unsigned int)best_triangle) {
+                    adjacency[a] = adjacency[end - 1];
+                    break;
+                }
+            }
+            remaining[vertex]--;
+        }
+        // Triangle vertices move to the front of the LRU cache
+        for (unsigned int vertex : cache) {
+            if (vertex != new_cache[0] && vertex != new_cache[1] && vertex != new_cache[2]) {
+                new_cache.push_back(vertex);
+            }
+        }
+        for (unsigned int i = VERTEX_CACHE_SIZE; i < new_cache.size(); i++) {
+            cache_position[new_cache[i]] = -1;
+            vertex_score[new_cache[i]] = get_vertex_score(-1, remaining[new_cache[i]]);
+        }
+        if (new_cache.size() > VERTEX_CACHE_SIZE) {
+            new_cache.resize(VERTEX_CACHE_SIZE);
+        }
+        cache.swap(new_cache);
+
+        // Only triangles touching the cache change score, the best next one is among them
+        for (unsigned int i = 0; i < cache.size(); i++) {
+            cache_position[cache[i]] = i;
+            vertex_score[cache[i]] = get_vertex_score(i, remaining[cache[i]]);
+        }
+        best_triangle = -1;
+        best_score = -1.0f;
+        for (unsigned int vertex : cache) {
+            unsigned int begin = adjacency_offset[vertex];
+            for (unsigned int a = begin; a < begin + remaining[vertex]; a++) {
+                unsigned int t = adjacency[a];
+                float score = vertex_score[indices[3 * t]] + vertex_score[indices[3 * t + 1]] + vertex_score[indices[3 * t + 2]];
+                triangle_score[t] = score;
+                if (score > best_score) {
+                    best_score = score;
+                    best_triangle = t;
+                }
+            }
+        }
+
+        // Nothing left around the cache, continue with the next triangle not drawn yet
+        if (best_triangle < 0) {
+            while (next_unemitted < n_triangles && emitted[next_unemitted]) {
+                next_unemitted++;
+            }
+            if (next_unemitted < n_triangles) {
+                best_triangle = next_unemitted;
+            }
+        }
+    }
+
+    indices.swap(result);
+}
+
+void optimize_vertex_fetch(mesh_data& mesh) {
+    unsigned int n_vertices = mesh.positions.size() / 3;
+    vector<int> remap(n_vertices, -1);
+    unsigned int next_vertex = 0;
+    vector<float> positions(mesh.positions.size());
+    vector<float> colors(mesh.colors.size());
+
+    for (unsigned int& index : mesh.indices) {
+        if (remap[index] < 0) {
+            remap[index] = next_vertex;
+            for (int k = 0; k < 3; k++) {
+                positions[3 * next_vertex + k] = mesh.positions[3 * index + k];
+                colors[3 * next_vertex + k] = mesh.colors[3 * index + k];
+            }
+            next_vertex++;
+        }
+        index = remap[index];
+    }
+
+    // Vertices no triangle uses are dropped
+    positions.resize(3 * next_vertex);
+    colors.resize(3 * next_vertex);
+    mesh.positions.swap(positions);
+    mesh.colors.swap(colors);
+}
+
+unsigned int choose_index_size(unsigned int n_vertices) {
+    return n_vertices <= 65536 ? 2 : 4;
+}
+
+void narrow_indices(const unsigned int* indices, unsigned int n_indices, uint16_t* result) {
+    for (unsigned int i = 0; i < n_indices; i++) {
+        result[i] = (uint16_t)indices[i];
+    }
+}
+
+static mesh_optimize_stats optimize_level(mesh_data& mesh) {
+    mesh_optimize_stats stats;
+    unsigned int n_vertices = mesh.positions.size() / 3;
+    stats.acmr_before = compute_acmr(mesh.indices, n_vertices, VERTEX_CACHE_SIZE);
+    optimize_vertex_cache(mesh.indices, n_vertices);
+    optimize_vertex_fetch(mesh);
+    stats.acmr_after = compute_acmr(mesh.indices, mesh.positions.size() / 3, VERTEX_CACHE_SIZE);
+    stats.index_size = choose_index_size(mesh.positions.size() / 3);
+    return stats;
+}
+
+// Levels are optimized one by one so triangles never move between them, the ACMR is the full mesh's
+mesh_optimize_stats optimize_mesh(mesh_data& mesh) {
+    if (mesh.lods.empty()) {
+        return optimize_level(mesh);
+    }
+    mesh_optimize_stats stats;
+    mesh_data result;
+    for (unsigned int level = 0; level < mesh.lods.size(); level++) {
+        mesh_data lod = get_mesh_lod(mesh, level);
+        mesh_optimize_stats level_stats = optimize_level(lod);
+        if (level == 0) {
+            stats = level_stats;
+        }
+        stats.index_size = max(stats.index_size, level_stats.index_size);
+        add_mesh_lod(result, lod, mesh.lods[level].error);
+    }
+    mesh = result;
+    return stats;
+}
@@ -0,0 +1,36 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include "mesh.hpp"
+
+#include <stdint.h>
+#include <vector>
+using namespace std;
+
+// Size of the post transform vertex cache the optimizer aims for
+#define VERTEX_CACHE_SIZE 32
+
+struct mesh_optimize_stats {
+    float acmr_before; // Average cache miss ratio, vertex shader runs per triangle
+    float acmr_after;
+    unsigned int index_size; // 2 or 4 bytes
+};
+
+// Average number of vertex shader invocations per triangle with a FIFO cache
+float compute_acmr(const vector<unsigned int>& indices, unsigned int n_vertices, unsigned int cache_size);
+
+// Reorders triangles for vertex cache hits (Tom Forsyth's linear speed algorithm)
+void optimize_vertex_cache(vector<unsigned int>& indices, unsigned int n_vertices);
+
+// Reorders vertices into first use order so fetches walk the buffers linearly
+void optimize_vertex_fetch(mesh_data& mesh);
+
+// Smallest index size that can address every vertex of the mesh
+unsigned int choose_index_size(unsigned int n_vertices);
+
+void narrow_indices(const unsigned int* indices, unsigned int n_indices, uint16_t* result);
+
+// Runs all of the above on a mesh, on each of its levels of detail separately
+mesh_optimize_stats optimize_mesh(mesh_data& mesh);
+
+#endif
@@ -0,0 +1,355 @@
+#include "triangulate.hpp"
+#include "../utils/predicates.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+// Sweep line triangulation: split the polygon into y-monotone pieces with diagonals
+// (de Berg et al., Computational Geometry ch. 3), then triangulate every piece in linear time.
+// Everything is O(n log n), holes are handled by the same sweep.
+
+enum vertex_type { START_VERTEX, END_VERTEX, SPLIT_VERTEX, MERGE_VERTEX, REGULAR_VERTEX };
+
+struct sweep_vertex {
+    double x;
+    double y;
+    int prev; // Neighbours along the contour, interior always on the left of prev -> this -> next
+    int next;
+    vertex_type type;
+};
+
+static double orient(const sweep_vertex& a, const sweep_vertex& b, const sweep_vertex& c) {
+    return orient2d(a.x, a.y, b.x, b.y, c.x, c.y);
+}
+
+// Sweep goes from top to bottom, equal heights go left to right
+static bool is_above(const sweep_vertex& a, const sweep_vertex& b) {
+    return a.y > b.y || (a.y == b.y && a.x < b.x);
+}
+
+struct sweep_state {
+    const vector<sweep_vertex>* vertices;
+    double y;
+    double query_x;
+};
+
+// Status edges are ordered by their x at the current sweep height. Edge i runs from
+// vertex i to its next vertex, -1 is the position of the vertex being queried.
+struct edge_compare {
+    const sweep_state* state;
+
+    double x_at_sweep(int edge) const {
+        if (edge < 0) {
+            return state->query_x;
+        }
+        const sweep_vertex& a = (*state->vertices)[edge];
+        const sweep_vertex& b = (*state->vertices)[a.next];
+        if (a.y == b.y) {
+            // Horizontal edges are left of anything else at their height
+            return max(a.x, b.x);
+        }
+        double t = (state->y - a.y) / (b.y - a.y);
+        t = min(1.0, max(0.0, t));
+        return a.x + t * (b.x - a.x);
+    }
+
+    bool operator()(int left, int right) const {
+        double left_x = x_at_sweep(left);
+        double right_x = x_at_sweep(right);
+        if (left_x != right_x) {
+            return left_x < right_x;
+        }
+        return left < right;
+    }
+};
+
+static void emit_triangle(const vector<sweep_vertex>& vertices, int a, int b, int c, vector<unsigned int>& indices) {
+    // Always counter clockwise
+    if (orient(vertices[a], vertices[b], vertices[c]) < 0.0) {
+        swap(b, c);
+    }
+    indices.push_back(a);
+    indices.push_back(b);
+    indices.push_back(c);
+}
+
+// Triangulates one y-monotone piece given in counter clockwise order
+static void triangulate_monotone_piece(const vector<sweep_vertex>& vertices, const vector<int>& piece, vector<unsigned int>& indices) {
+    int n = piece.size();
+    if (n < 3) {
+        return;
+    }
+
+    int top = 0;
+    int bottom = 0;
+    for (int i = 1; i < n; i++) {
+        if (is_above(vertices[piece[i]], vertices[piece[top]])) top = i;
+        if (is_above(vertices[piece[bottom]], vertices[piece[i]])) bottom = i;
+    }
+
+    // Counter clockwise from the top runs down the left chain, clockwise down the right
+    // chain. Both are already sorted, merge them top to bottom.
+    vector<int> sorted;
+    vector<bool> on_left;
+    sorted.reserve(n);
+    on_left.reserve(n);
+    sorted.push_back(piece[top]);
+    on_left.push_back(true);
+    int left = (top + 1) % n;
+    int right = (top + n - 1) % n;
+    while (left != bottom || right != bottom) {
+        bool take_left;
+        if (left == bottom) {
+            take_left = false;
+        } else if (right == bottom) {
+            take_left = true;
+        } else {
+            take_left = is_above(vertices[piece[left]], vertices[piece[right]]);
+        }
+        if (take_left) {
+            sorted.push_back(piece[left]);
+            on_left.push_back(true);
+            left = (left + 1) % n;
+        } else {
+            sorted.push_back(piece[right]);
+            on_left.push_back(false);
+            right = (right + n - 1) % n;
+        }
+    }
+    sorted.push_back(piece[bottom]);
+    on_left.push_back(true);
+
+    vector<int> stack;
+    stack.push_back(0);
+    stack.push_back(1);
+    for (int j = 2; j < n - 1; j++) {
+        if (on_left[j] != on_left[stack.back()]) {
+            // Opposite chain, everything on the stack can see vertex j
+            for (size_t k = 0; k + 1 < stack.size(); k++) {
+                emit_triangle(vertices, sorted[j], sorted[stack[k]], sorted[stack[k + 1]], indices);
+            }
+            int previous = stack.back();
+            stack.clear();
+            stack.push_back(previous);
+            stack.push_back(j);
+        } else {
+            // Same chain, cut off triangles while the stack top is convex
+            int last = stack.back();
+            stack.pop_back();
+            while (!stack.empty()) {
+                const sweep_vertex& current = vertices[sorted[j]];
+                const sweep_vertex& middle = vertices[sorted[last]];
+                const sweep_vertex& upper = vertices[sorted[stack.back()]];
+                double turn = on_left[j] ? orient(upper, middle, current) : orient(current, middle, upper);
+                if (turn <= 0.0) {
+                    break;
+                }
+                emit_triangle(vertices, sorted[j], sorted[last], sorted[stack.back()], indices);
+                last = stack.back();
+                stack.pop_back();
+            }
+            stack.push_back(last);
+            stack.push_back(j);
+        }
+    }
+
+    // The bottom vertex sees whatever is left on the stack
+    for (size_t k = 0; k + 1 < stack.size(); k++) {
+        emit_triangle(vertices, sorted[n - 1], sorted[stack[k]], sorted[stack[k + 1]], indices);
+    }
+}
+
+bool triangulate_monotone(const float vertices[], const int contour_sizes[], int n_contours, vector<unsigned int>& indices) {
+    indices.clear();
+
+    // Outer contour counter clockwise, holes clockwise, so the interior is always on the left
+    vector<sweep_vertex> sweep_vertices;
+    int first = 0;
+    for (int c = 0; c < n_contours; c++) {
+        int n = contour_sizes[c];
+        if (n < 3) {
+            return false;
+        }
+        double signed_area = 0.0;
+        for (int i = 0; i < n; i++) {
+            int j = (i + 1) % n;
+            signed_area += (double)vertices[3 * (first + i)] * vertices[3 * (first + j) + 1] -
+                           (double)vertices[3 * (first + j)] * vertices[3 * (first + i) + 1];
+        }
+        bool reverse = (c == 0) != (signed_area > 0.0);
+        for (int i = 0; i < n; i++) {
+            sweep_vertex vertex;
+            vertex.x = vertices[3 * (first + i)];
+            vertex.y = vertices[3 * (first + i) + 1];
+            int next = first + (i + 1) % n;
+            int prev = first + (i + n - 1) % n;
+            vertex.next = reverse ? prev : next;
+            vertex.prev = reverse ? next : prev;
+            sweep_vertices.push_back(vertex);
+        }
+        first += n;
+    }
+    int n_vertices = sweep_vertices.size();
+
+    for (sweep_vertex& vertex : sweep_vertices) {
+        const sweep_vertex& prev = sweep_vertices[vertex.prev];
+        const sweep_vertex& next = sweep_vertices[vertex.next];
+        bool convex = orient(prev, vertex, next) > 0.0;
+        if (is_above(vertex, prev) && is_above(vertex, next)) {
+            vertex.type = convex ? START_VERTEX : SPLIT_VERTEX;
+        } else if (is_above(prev, vertex) && is_above(next, vertex)) {
+            vertex.type = convex ? END_VERTEX : MERGE_VERTEX;
+        } else {
+            vertex.type = REGULAR_VERTEX;
+        }
+    }
+
+    vector<int> order(n_vertices);
+    for (int i = 0; i < n_vertices; i++) {
+        order[i] = i;
+    }
+    sort(order.begin(), order.end(), [&](int a, int b) {
+        return is_above(sweep_vertices[a], sweep_vertices[b]);
+    });
+
+    // Sweep, adding diagonals at split and merge vertices
+    sweep_state state = {&sweep_vertices, 0.0, 0.0};
+    edge_compare compare = {&state};
+    set<int, edge_compare> status(compare);
+    vector<set<int, edge_compare>::iterator> status_position(n_vertices, status.end());
+    vector<int> helper(n_vertices, -1);
+    vector<pair<int, int>> diagonals;
+
+    for (int v : order) {
+        const sweep_vertex& vertex = sweep_vertices[v];
+        state.y = vertex.y;
+        state.query_x = vertex.x;
+        int previous_edge = vertex.prev; // Edge from prev to v
+
+        // Edge directly left of v in the status
+        int left_edge = -1;
+        if (vertex.type == SPLIT_VERTEX || vertex.type == MERGE_VERTEX ||
+            (vertex.type == REGULAR_VERTEX && is_above(vertex, sweep_vertices[vertex.prev]))) {
+            if (vertex.type == MERGE_VERTEX) {
+                // The edge ending here has to leave the status before searching
+                if (status_position[previous_edge] != status.end()) {
+                    if (sweep_vertices[helper[previous_edge]].type == MERGE_VERTEX) {
+                        diagonals.push_back(make_pair(v, helper[previous_edge]));
+                    }
+                    status.erase(status_position[previous_edge]);
+                    status_position[previous_edge] = status.end();
+                }
+            }
+            set<int, edge_compare>::iterator found = status.lower_bound(-1);
+            if (found == status.begin()) {
+                // Nothing left of a vertex that needs one, the input is not a valid polygon
+                return false;
+            }
+            --found;
+            left_edge = *found;
+        }
+
+        switch (vertex.type) {
+            case START_VERTEX:
+                status_position[v] = status.insert(v).first;
+                helper[v] = v;
+                break;
+            case END_VERTEX:
+            case REGULAR_VERTEX:
+                if (vertex.type == END_VERTEX || is_above(sweep_vertices[vertex.prev], vertex)) {
+                    // Interior to the right, the edge above ends here
+                    if (status_position[previous_edge] == status.end()) {
+                        return false;
+                    }
+                    if (sweep_vertices[helper[previous_edge]].type == MERGE_VERTEX) {
+                        diagonals.push_back(make_pair(v, helper[previous_edge]));
+                    }
+                    status.erase(status_position[previous_edge]);
+                    status_position[previous_edge] = status.end();
+                    if (vertex.type == REGULAR_VERTEX) {
+                        status_position[v] = status.insert(v).first;
+                        helper[v] = v;
+                    }
+                } else {
+                    if (sweep_vertices[helper[left_edge]].type == MERGE_VERTEX) {
+                        diagonals.push_back(make_pair(v, helper[left_edge]));
+                    }
+                    helper[left_edge] = v;
+                }
+                break;
+            case SPLIT_VERTEX:
+                diagonals.push_back(make_pair(v, helper[left_edge]));
+                helper[left_edge] = v;
+                status_position[v] = status.insert(v).first;
+                helper[v] = v;
+                break;
+            case MERGE_VERTEX:
+                if (sweep_vertices[helper[left_edge]].type == MERGE_VERTEX) {
+                    diagonals.push_back(make_pair(v, helper[left_edge]));
+                }
+                helper[left_edge] = v;
+                break;
+        }
+    }
+
+    // Outgoing half edges per vertex: the contour edge plus both directions of every diagonal
+    vector<vector<int>> outgoing(n_vertices);
+    for (int v = 0; v < n_vertices; v++) {
+        outgoing[v].push_back(sweep_vertices[v].next);
+    }
+    for (const pair<int, int>& diagonal : diagonals) {
+        outgoing[diagonal.first].push_back(diagonal.second);
+        outgoing[diagonal.second].push_back(diagonal.first);
+    }
+    // Sort counter clockwise by angle, contour neighbours are added so the turn back is known
+    vector<vector<int>> around(n_vertices);
+    for (int v = 0; v < n_vertices; v++) {
+        around[v] = outgoing[v];
+        around[v].push_back(sweep_vertices[v].prev);
+        const sweep_vertex& center = sweep_vertices[v];
+        sort(around[v].begin(), around[v].end(), [&](int a, int b) {
+            return atan2(sweep_vertices[a].y - center.y, sweep_vertices[a].x - center.x) <
+                   atan2(sweep_vertices[b].y - center.y, sweep_vertices[b].x - center.x);
+        });
+    }
+
+    // Walk every face, each interior half edge is used by exactly one monotone piece
+    vector<vector<int>> used(n_vertices);
+    for (int v = 0; v < n_vertices; v++) {
+        used[v].assign(outgoing[v].size(), 0);
+    }
+    vector<int> piece;
+    for (int start = 0; start < n_vertices; start++) {
+        for (size_t e = 0; e < outgoing[start].size(); e++) {
+            if (used[start][e]) {
+                continue;
+            }
+            piece.clear();
+            int from = start;
+            int to = outgoing[start][e];
+            used[start][e] = 1;
+            piece.push_back(from);
+            while (to != start) {
+                if ((int)piece.size() > n_vertices) {
+                    return false;
+                }
+                // Next edge is the one just clockwise of the way back
+                vector<int>& neighbours = around[to];
+                int back = find(neighbours.begin(), neighbours.end(), from) - neighbours.begin();
+                int next = neighbours[(back + neighbours.size() - 1) % neighbours.size()];
+                vector<int>& out = outgoing[to];
+                int out_index = find(out.begin(), out.end(), next) - out.begin();
+                if (out_index == (int)out.size()) {
+                    return false;
+                }
+                used[to][out_index] = 1;
+                piece.push_back(to);
+                from = to;
+                to = next;
+            }
+            triangulate_monotone_piece(sweep_vertices, piece, indices);
+        }
+    }
+    return true;
+}
@@ -4,7 +4,7 @@
 #include "../glm/gtc/matrix_transform.hpp"
 #include "../glm/gtc/type_ptr.hpp"
 
-#include "../utils/shaders.hpp"
+#include "../render/shader_cache.hpp"
 #include "quad.hpp"
 
 QUAD::QUAD(float vertices[12], float colors[12]) {
@@ -15,53 +15,42 @@ QUAD::QUAD(float vertices[12], float colors[12]) {
     };
 
     // Store the indices in ebo
-    unsigned int ebo;
-    glGenBuffers(1, &ebo);
+    ebo = create_buffer();
 
     // Store the points in a GLbuffer
-    points_vbo = 0;
-    glGenBuffers(1, &points_vbo);
+    points_vbo = create_buffer();
 
     // Store the color in a buffer aswell
-    color_vbo = 0;
-    glGenBuffers(1, &color_vbo);
+    color_vbo = create_buffer();
 
     // Create a vertex array object
-    vao = 0;
-    glGenVertexArrays(1, &vao);
-    glBindVertexArray(vao);
+    vao = create_vertex_array();
+    glBindVertexArray(vao.get());
 
-    glBindBuffer(GL_ARRAY_BUFFER, points_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, points_vbo.get());
     glBufferData(GL_ARRAY_BUFFER, 12 * sizeof(float), vertices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo.get());
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), NULL);
     
-    glBindBuffer(GL_ARRAY_BUFFER, color_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, color_vbo.get());
     glBufferData(GL_ARRAY_BUFFER, 12 * sizeof(float), colors, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo.get());
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), NULL);
 
     glEnableVertexAttribArray(0);
     glEnableVertexAttribArray(1);
 
-    shader_programme = create_shaders_from_files("test_vs.glsl", "test_fs.glsl");
+    shader_programme = get_shader_program("test_vs.glsl", "test_fs.glsl", 0);
 };
 
 void QUAD::draw() {
     glUseProgram(shader_programme);
-    glBindVertexArray(vao);
-    // Draw points 0-6 from the currently bound VAO with current in-use shader
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    // Retrieve the matrix uniform location and set the matrix
+    // The program is shared with other shapes, so the transform has to be set before drawing
     unsigned int transformLoc = glGetUniformLocation(shader_programme, "transform");
     glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
-}
-
-void QUAD::delete_buffers() {
-    glDeleteBuffers(1, &color_vbo);
-    glDeleteBuffers(1, &points_vbo);
-    glDeleteBuffers(1, &ebo);
-    glDeleteBuffers(1, &vao);
+    glBindVertexArray(vao.get());
+    // Draw points 0-6 from the currently bound VAO with current in-use shader
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 }
@@ -5,20 +5,20 @@
 #include <GLFW/glfw3.h>
 #include "../glm/glm.hpp"
 
+#include "../render/gl_handles.hpp"
 #include "shape.hpp"
 
 class QUAD: public SHAPE {
     public:
         QUAD(float vertices[12], float colors[12]);
         void draw();
-        void delete_buffers();
 
     private:
-        GLuint points_vbo;
-        GLuint color_vbo;
-        GLuint ebo;
-        GLuint vao;
-        GLuint shader_programme;
+        GPU_BUFFER points_vbo;
+        GPU_BUFFER color_vbo;
+        GPU_BUFFER ebo;
+        GPU_VERTEX_ARRAY vao;
+        GLuint shader_programme; // Owned by the shader cache
 };
 
 #endif
\ No newline at end of file
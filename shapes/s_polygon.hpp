@@ -5,31 +5,24 @@
 #include <GLFW/glfw3.h>
 #include "../glm/glm.hpp"
 
+#include "../render/gl_handles.hpp"
 #include "shape.hpp"
-#include "../utils/dlinked_list.hpp"
-#include "../utils/linked_list.hpp"
 
 
 class SPOLY: public SHAPE {
     public:
         SPOLY(float vertices[], int n_vertices);
-        dlinked* array_to_dlinked(float vertices[]);
         int n_vertices;
         void draw();
-        void delete_buffers();
 
     private:
-        GLuint points_vbo;
-        GLuint color_vbo;
-        GLuint ebo;
-        GLuint vao;
-        GLuint shader_programme;
+        GPU_BUFFER points_vbo;
+        GPU_BUFFER color_vbo;
+        GPU_BUFFER ebo;
+        GPU_VERTEX_ARRAY vao;
+        GLuint shader_programme; // Owned by the shader cache
         unsigned int n_elements;
-        bool is_ear(dlinked* poly_vertices, dlinked* triangle_node);
-        bool is_convex(dlinked* A, dlinked* B, dlinked* C);
-        void print_linked(linked* node);
-        bool point_in_triangle(dlinked* first, dlinked* second, dlinked* third, dlinked* point);
-        float get_triangle_area(dlinked* first, dlinked* second, dlinked* third);
+        GLenum index_type;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -9,6 +9,9 @@
 SHAPE::SHAPE() {
     xOffset = 0.0f;
     yOffset = 0.0f;
+    local_bounds = {0.0f, 0.0f, 0.0f, 0.0f};
+    spatial_grid = NULL;
+    spatial_id = 0;
     this->update_transform_matrix();
 };
 
@@ -40,4 +43,32 @@ void SHAPE::update_transform_matrix() {
 
 void SHAPE::set_delta_time(double new_delta_time) {
     delta_time = new_delta_time;
+}
+
+const glm::mat4& SHAPE::get_transform() {
+    return transform;
+}
+
+void SHAPE::set_local_bounds(const aabb& bounds) {
+    local_bounds = bounds;
+    if (spatial_grid) {
+        spatial_grid->update(spatial_id, get_bounds());
+    }
+}
+
+aabb SHAPE::get_bounds() {
+    return aabb_translate(local_bounds, xOffset, yOffset);
+}
+
+// Moves leave the grid alone so shapes can move on several threads at once, this catches it up
+void SHAPE::sync_spatial_index() {
+    if (spatial_grid) {
+        spatial_grid->update(spatial_id, get_bounds());
+    }
+}
+
+void SHAPE::set_spatial_index(SPATIAL_GRID* grid, unsigned int id) {
+    spatial_grid = grid;
+    spatial_id = id;
+    grid->insert(id, get_bounds());
 }
\ No newline at end of file
@@ -5,6 +5,9 @@
 #include <GLFW/glfw3.h>
 #include "../glm/glm.hpp"
 
+#include "../utils/aabb.hpp"
+#include "../utils/spatial_grid.hpp"
+
 class SHAPE {
     public:
         SHAPE();
@@ -13,12 +16,20 @@ class SHAPE {
         void move_down(float delta_offset);
         void move_left(float delta_offset);
         void set_delta_time(double new_delta_time);
+        const glm::mat4& get_transform();
+        void set_local_bounds(const aabb& bounds);
+        aabb get_bounds();
+        void set_spatial_index(SPATIAL_GRID* grid, unsigned int id);
+        void sync_spatial_index();
 
     protected:
         double delta_time;
         float xOffset;
         float yOffset;
         glm::mat4 transform;
+        aabb local_bounds;
+        SPATIAL_GRID* spatial_grid;
+        unsigned int spatial_id;
         void update_transform_matrix();
 };
 
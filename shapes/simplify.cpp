@@ -0,0 +1,204 @@
+#include "simplify.hpp"
+#include "../utils/predicates.hpp"
+#include "../utils/spatial_grid.hpp"
+
+#include <math.h>
+#include <queue>
+#include <algorithm>
+
+struct removal_candidate {
+    double area;
+    int index;
+    unsigned int version;
+
+    bool operator>(const removal_candidate& other) const {
+        return area > other.area;
+    }
+};
+
+static double triangle_area(const float vertices[], int a, int b, int c) {
+    return fabs(orient2d(
+        vertices[a * 3], vertices[a * 3 + 1],
+        vertices[b * 3], vertices[b * 3 + 1],
+        vertices[c * 3], vertices[c * 3 + 1])) * 0.5;
+}
+
+static aabb get_point_bounds(const float vertices[], int i) {
+    aabb bounds = {vertices[i * 3], vertices[i * 3 + 1], vertices[i * 3], vertices[i * 3 + 1]};
+    return bounds;
+}
+
+vector<int> simplify_polygon(const float vertices[], int n_vertices, int target_vertices) {
+    vector<int> prev(n_vertices), next(n_vertices);
+    vector<unsigned int> versions(n_vertices, 0);
+    vector<bool> removed(n_vertices, false);
+    for (int i = 0; i < n_vertices; i++) {
+        prev[i] = (i + n_vertices - 1) % n_vertices;
+        next[i] = (i + 1) % n_vertices;
+    }
+
+    // Vertices are indexed in a grid so the containment test only looks near the triangle
+    aabb extent = get_point_bounds(vertices, 0);
+    for (int i = 1; i < n_vertices; i++) {
+        extent.min_x = min(extent.min_x, vertices[i * 3]);
+        extent.min_y = min(extent.min_y, vertices[i * 3 + 1]);
+        extent.max_x = max(extent.max_x, vertices[i * 3]);
+        extent.max_y = max(extent.max_y, vertices[i * 3 + 1]);
+    }
+    float cell_size = max(extent.max_x - extent.min_x, extent.max_y - extent.min_y) / sqrtf((float)n_vertices);
+    SPATIAL_GRID grid(cell_size > 0.0f ? cell_size : 1.0f);
+    for (int i = 0; i < n_vertices; i++) {
+        grid.insert(i, get_point_bounds(vertices, i));
+    }
+
+    priority_queue<removal_candidate, vector<removal_candidate>, greater<removal_candidate>> queue;
+    for (int i = 0; i < n_vertices; i++) {
+        removal_candidate candidate = {triangle_area(vertices, prev[i], i, next[i]), i, 0};
+        queue.push(candidate);
+    }
+
+    int remaining = n_vertices;
+    double last_area = 0.0;
+    vector<unsigned int> nearby;
+    while (remaining > target_vertices && remaining > 3 && !queue.empty()) {
+        removal_candidate candidate = queue.top();
+        queue.pop();
+        int i = candidate.index;
+        if (removed[i] || candidate.version != versions[i]) {
+            continue;
+        }
+
+        // The new edge prev-next can only cross the outline if some vertex sits in the triangle.
+        // Blocked vertices wait until a neighbour goes and their triangle changes.
+        int a = prev[i];
+        int c = next[i];
+        aabb bounds = get_point_bounds(vertices, a);
+        for (int j : {i, c}) {
+            bounds.min_x = min(bounds.min_x, vertices[j * 3]);
+            bounds.min_y = min(bounds.min_y, vertices[j * 3 + 1]);
+            bounds.max_x = max(bounds.max_x, vertices[j * 3]);
+            bounds.max_y = max(bounds.max_y, vertices[j * 3 + 1]);
+        }
+        grid.query_rect(bounds, nearby);
+        bool blocked = false;
+        for (unsigned int j : nearby) {
+            if ((int)j == a || (int)j == i || (int)j == c) {
+                continue;
+            }
+            if (point_in_triangle(
+                vertices[a * 3], vertices[a * 3 + 1], vertices[i * 3], vertices[i * 3 + 1],
+                vertices[c * 3], vertices[c * 3 + 1], vertices[j * 3], vertices[j * 3 + 1])) {
+                    blocked = true;
+                    break;
+            }
+        }
+        if (blocked) {
+            continue;
+        }
+
+        removed[i] = true;
+        grid.remove(i);
+        next[a] = c;
+        prev[c] = a;
+        remaining--;
+        last_area = max(last_area, candidate.area);
+
+        // Neighbours never get cheaper than what was just removed, keeps the order stable
+        for (int j : {a, c}) {
+            versions[j]++;
+            removal_candidate update = {max(triangle_area(vertices, prev[j], j, next[j]), last_area), j, versions[j]};
+            queue.push(update);
+        }
+    }
+
+    vector<int> kept;
+    for (int i = 0; i < n_vertices; i++) {
+        if (!removed[i]) {
+            kept.push_back(i);
+        }
+    }
+    return kept;
+}
+
+static float point_segment_distance(const float* p, const float* a, const float* b) {
+    float dx = b[0] - a[0];
+    float dy = b[1] - a[1];
+    float length2 = dx * dx + dy * dy;
+    float t = length2 > 0.0f ? ((p[0] - a[0]) * dx + (p[1] - a[1]) * dy) / length2 : 0.0f;
+    t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+    float x = a[0] + t * dx - p[0];
+    float y = a[1] + t * dy - p[1];
+    return sqrtf(x * x + y * y);
+}
+
+vector<polygon_lod> build_polygon_lods(const float vertices[], int n_vertices, int max_levels, float ratio, int min_vertices) {
+    vector<polygon_lod> lods(1);
+    lods[0].vertices.assign(vertices, vertices + n_vertices * 3);
+    lods[0].error = 0.0f;
+
+    // Every level is simplified from the one before, original holds where its vertices came from
+    vector<int> original(n_vertices);
+    for (int i = 0; i < n_vertices; i++) {
+        original[i] = i;
+    }
+    for (int level = 1; level < max_levels; level++) {
+        const vector<float>& source = lods.back().vertices;
+        int n_source = source.size() / 3;
+        int target = max(min_vertices, (int)(n_source * ratio));
+        if (target >= n_source) {
+            break;
+        }
+        vector<int> kept = simplify_polygon(source.data(), n_source, target);
+        if ((int)kept.size() >= n_source) {
+            break;
+        }
+
+        polygon_lod lod;
+        vector<int> kept_original(kept.size());
+        for (size_t i = 0; i < kept.size(); i++) {
+            lod.vertices.insert(lod.vertices.end(), &source[kept[i] * 3], &source[kept[i] * 3 + 3]);
+            kept_original[i] = original[kept[i]];
+        }
+
+        // Measured against the input, every original vertex lies between two kept ones
+        lod.error = 0.0f;
+        for (size_t i = 0; i < kept_original.size(); i++) {
+            int first = kept_original[i];
+            int last = kept_original[(i + 1) % kept_original.size()];
+            for (int j = (first + 1) % n_vertices; j != last; j = (j + 1) % n_vertices) {
+                lod.error = max(lod.error, point_segment_distance(&vertices[j * 3], &vertices[first * 3], &vertices[last * 3]));
+            }
+        }
+
+        lods.push_back(lod);
+        original = kept_original;
+    }
+    return lods;
+}
+
+mesh_data make_polygon_lod_mesh(const float vertices[], int n_vertices, float r, float g, float b) {
+    vector<polygon_lod> outlines = build_polygon_lods(
+        vertices, n_vertices, POLYGON_LOD_LEVELS, POLYGON_LOD_RATIO, POLYGON_LOD_MIN_VERTICES);
+    mesh_data mesh;
+    for (size_t level = 0; level < outlines.size(); level++) {
+        mesh_data outline = make_polygon_mesh(outlines[level].vertices.data(), outlines[level].vertices.size() / 3, r, g, b);
+        if (outline.indices.empty()) {
+            if (level == 0) {
+                return outline;
+            }
+            continue;
+        }
+        add_mesh_lod(mesh, outline, outlines[level].error);
+    }
+    return mesh;
+}
+
+int select_polygon_lod(const float errors[], int n_levels, float pixels_per_unit, float max_pixel_error) {
+    int level = 0;
+    for (int i = 1; i < n_levels; i++) {
+        if (errors[i] * pixels_per_unit <= max_pixel_error) {
+            level = i;
+        }
+    }
+    return level;
+}
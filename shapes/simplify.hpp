@@ -0,0 +1,38 @@
+#ifndef SIMPLIFY_H
+#define SIMPLIFY_H
+
+#include "mesh.hpp"
+
+#include <vector>
+using namespace std;
+
+// Levels of detail per polygon, each one keeps a quarter of the vertices of the one before
+#define POLYGON_LOD_LEVELS 5
+#define POLYGON_LOD_RATIO 0.25f
+#define POLYGON_LOD_MIN_VERTICES 8
+
+// One level of detail of a polygon outline, vertices are x, y, z like the input.
+// error is the largest distance from an original vertex to the simplified outline.
+struct polygon_lod {
+    vector<float> vertices;
+    float error;
+};
+
+// Visvalingam-Whyatt on a single closed outline: keeps removing the vertex that spans the
+// smallest triangle with its neighbours until target_vertices are left. A vertex is never
+// removed while its triangle contains another vertex, so the outline can not cross itself.
+// Returns the indices of the kept vertices, in order.
+vector<int> simplify_polygon(const float vertices[], int n_vertices, int target_vertices);
+
+// Level 0 is the input, every next level keeps ratio of the vertices of the one before,
+// stopping at min_vertices or when simplification gets stuck
+vector<polygon_lod> build_polygon_lods(const float vertices[], int n_vertices, int max_levels, float ratio, int min_vertices);
+
+// Triangulated polygon with the levels above as its levels of detail (see mesh_lod).
+// Levels that can not be triangulated are left out, no indices when the polygon itself can not.
+mesh_data make_polygon_lod_mesh(const float vertices[], int n_vertices, float r, float g, float b);
+
+// The coarsest level whose error stays under max_pixel_error on screen
+int select_polygon_lod(const float errors[], int n_levels, float pixels_per_unit, float max_pixel_error);
+
+#endif
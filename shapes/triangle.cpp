@@ -4,49 +4,40 @@
 #include "../glm/gtc/matrix_transform.hpp"
 #include "../glm/gtc/type_ptr.hpp"
 
-#include "../utils/shaders.hpp"
+#include "../render/shader_cache.hpp"
 #include "triangle.hpp"
 
 TRIANGLE::TRIANGLE(float vertices[9], float colors[9]) {
     // Store the points in a GLbuffer
-    points_vbo = 0;
-    glGenBuffers(1, &points_vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, points_vbo);
+    points_vbo = create_buffer();
+    glBindBuffer(GL_ARRAY_BUFFER, points_vbo.get());
     glBufferData(GL_ARRAY_BUFFER, 9 * sizeof(float), vertices, GL_STATIC_DRAW);
 
     // Store the color in a buffer aswell
-    color_vbo = 0;
-    glGenBuffers(1, &color_vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, color_vbo);
+    color_vbo = create_buffer();
+    glBindBuffer(GL_ARRAY_BUFFER, color_vbo.get());
     glBufferData(GL_ARRAY_BUFFER, 9 * sizeof(float), colors, GL_STATIC_DRAW);
 
     // Create a vertex array object
-    vao = 0;
-    glGenVertexArrays(1, &vao);
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, points_vbo);
+    vao = create_vertex_array();
+    glBindVertexArray(vao.get());
+    glBindBuffer(GL_ARRAY_BUFFER, points_vbo.get());
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-    glBindBuffer(GL_ARRAY_BUFFER, color_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, color_vbo.get());
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, NULL);
 
     glEnableVertexAttribArray(0);
     glEnableVertexAttribArray(1);
 
-    shader_programme = create_shaders_from_files("test_vs.glsl", "test_fs.glsl");
+    shader_programme = get_shader_program("test_vs.glsl", "test_fs.glsl", 0);
 };
 
 void TRIANGLE::draw() {
     glUseProgram(shader_programme);
-    glBindVertexArray(vao);
-    // Draw points 0-3 from the currently bound VAO with current in-use shader
-    glDrawArrays(GL_TRIANGLES, 0, 3);
-    // Retrieve the matrix uniform location and set the matrix
+    // The program is shared with other shapes, so the transform has to be set before drawing
     unsigned int transformLoc = glGetUniformLocation(shader_programme, "transform");
     glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
+    glBindVertexArray(vao.get());
+    // Draw points 0-3 from the currently bound VAO with current in-use shader
+    glDrawArrays(GL_TRIANGLES, 0, 3);
 }
-
-void TRIANGLE::delete_buffers() {
-    glDeleteBuffers(1, &color_vbo);
-    glDeleteBuffers(1, &points_vbo);
-    glDeleteBuffers(1, &vao);
-}
\ No newline at end of file
@@ -5,19 +5,19 @@
 #include <GLFW/glfw3.h>
 #include "../glm/glm.hpp"
 
+#include "../render/gl_handles.hpp"
 #include "shape.hpp"
 
 class TRIANGLE: public SHAPE {
     public:
         TRIANGLE(float vertices[9], float colors[9]);
         void draw();
-        void delete_buffers();
 
     private:
-        GLuint points_vbo;
-        GLuint color_vbo;
-        GLuint vao;
-        GLuint shader_programme;
+        GPU_BUFFER points_vbo;
+        GPU_BUFFER color_vbo;
+        GPU_VERTEX_ARRAY vao;
+        GLuint shader_programme; // Owned by the shader cache
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "triangulate.hpp"
+#include "../utils/predicates.hpp"
+
+#include <cmath>
+
+// Circular doubly linked list, always in clockwise order since that is what is_convex expects
+static dlinked* array_to_dlinked(const float vertices[], int n_vertices, vector<dlinked>& storage) {
+    float signed_area = 0.0f;
+    for (int i = 0; i < n_vertices; i++) {
+        int j = (i + 1) % n_vertices;
+        signed_area += vertices[3 * i] * vertices[3 * j + 1] - vertices[3 * j] * vertices[3 * i + 1];
+    }
+    bool reverse = signed_area > 0.0f;
+
+    storage.resize(n_vertices);
+    for (int i = 0; i < n_vertices; i++) {
+        int index = reverse ? n_vertices - 1 - i : i;
+        dlinked* node = &storage[i];
+        node->x = vertices[3 * index];
+        node->y = vertices[3 * index + 1];
+        node->z = vertices[3 * index + 2];
+        node->index = index;
+        node->parent_node = &storage[(i + n_vertices - 1) % n_vertices];
+        node->child_node = &storage[(i + 1) % n_vertices];
+    }
+    return &storage[0];
+}
+
+static bool is_ear(dlinked* triangle_node, int n_remaining) {
+    if (!is_convex(triangle_node->parent_node, triangle_node, triangle_node->child_node)) {
+        return false;
+    }
+
+    // No other remaining vertex may lie inside the ear
+    dlinked* current_node = triangle_node->child_node->child_node;
+    for (int i = 0; i < n_remaining - 3; i++) {
+        if (point_in_triangle(triangle_node->parent_node, triangle_node, triangle_node->child_node, current_node)) {
+            return false;
+        }
+        current_node = current_node->child_node;
+    }
+    return true;
+}
+
+bool triangulate_polygon(
+    const float vertices[], const int contour_sizes[], int n_contours,
+    triangulation_engine engine, vector<unsigned int>& indices) {
+        if (engine == TRIANGULATE_MONOTONE) {
+            return triangulate_monotone(vertices, contour_sizes, n_contours, indices);
+        }
+        if (n_contours != 1) {
+            // Ear clipping here has no hole bridging
+            indices.clear();
+            return false;
+        }
+        return triangulate_ear_clipping(vertices, contour_sizes[0], indices);
+}
+
+bool triangulate_ear_clipping(const float vertices[], int n_vertices, vector<unsigned int>& indices) {
+    indices.clear();
+    if (n_vertices < 3) {
+        return false;
+    }
+
+    vector<dlinked> storage;
+    dlinked* current_node = array_to_dlinked(vertices, n_vertices, storage);
+    int n_remaining = n_vertices;
+
+    // Walk around the polygon clipping ears, a full lap without an ear means the input is broken
+    int since_last_ear = 0;
+    while (n_remaining > 3) {
+        if (is_ear(current_node, n_remaining)) {
+            indices.push_back(current_node->parent_node->index);
+            indices.push_back(current_node->index);
+            indices.push_back(current_node->child_node->index);
+
+            // Unlink the ear tip
+            current_node->parent_node->child_node = current_node->child_node;
+            current_node->child_node->parent_node = current_node->parent_node;
+            current_node = current_node->parent_node;
+            n_remaining--;
+            since_last_ear = 0;
+            continue;
+        }
+
+        current_node = current_node->child_node;
+        since_last_ear++;
+        if (since_last_ear > n_remaining) {
+            return false;
+        }
+    }
+
+    indices.push_back(current_node->parent_node->index);
+    indices.push_back(current_node->index);
+    indices.push_back(current_node->child_node->index);
+    return true;
+}
+
+bool is_convex(dlinked* A, dlinked* B, dlinked* C) {
+    // The list is clockwise, so a convex corner turns clockwise. Collinear is not convex.
+    return orient2d(A->x, A->y, B->x, B->y, C->x, C->y) < 0.0;
+}
+
+bool point_in_triangle(dlinked* A, dlinked* B, dlinked* C, dlinked* P) {
+    // A point on an edge also blocks the ear
+    return point_in_triangle(A->x, A->y, B->x, B->y, C->x, C->y, P->x, P->y);
+}
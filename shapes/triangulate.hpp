@@ -0,0 +1,30 @@
+#ifndef TRIANGULATE_H
+#define TRIANGULATE_H
+
+#include "../utils/dlinked_list.hpp"
+
+#include <vector>
+using namespace std;
+
+enum triangulation_engine {
+    TRIANGULATE_EAR_CLIPPING, // Simple, quadratic in the worst case, no holes
+    TRIANGULATE_MONOTONE, // Sweep line monotone partition, O(n log n), supports holes
+};
+
+// Contours are stored back to back in vertices (x, y, z), the first one is the
+// outline and the rest are holes. Orientation of the contours does not matter.
+bool triangulate_polygon(
+    const float vertices[], const int contour_sizes[], int n_contours,
+    triangulation_engine engine, vector<unsigned int>& indices);
+
+// Ear clipping triangulation of a simple polygon, vertices are x, y, z.
+// Indices point into the given vertex array, returns false if no ear could be
+// found (self intersecting or degenerate input).
+bool triangulate_ear_clipping(const float vertices[], int n_vertices, vector<unsigned int>& indices);
+
+bool triangulate_monotone(const float vertices[], const int contour_sizes[], int n_contours, vector<unsigned int>& indices);
+
+bool is_convex(dlinked* A, dlinked* B, dlinked* C);
+bool point_in_triangle(dlinked* A, dlinked* B, dlinked* C, dlinked* P);
+
+#endif
@@ -0,0 +1,18 @@
+#version 400
+#include "sdf.glsl"
+
+in vec2 uv;
+in vec4 color;
+out vec4 frag_colour;
+
+uniform sampler2D atlas;
+
+void main() {
+#ifdef SDF_ALPHA
+    // Text glyphs keep their distance in alpha, the color comes from the vertices
+    float coverage = sdf_coverage(texture(atlas, uv).a);
+    frag_colour = vec4(color.rgb, color.a * coverage);
+#else
+    frag_colour = texture(atlas, uv) * color;
+#endif
+}
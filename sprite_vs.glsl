@@ -0,0 +1,13 @@
+#version 400
+layout(location = 0) in vec2 vertex_position;
+layout(location = 1) in vec2 vertex_uv;
+layout(location = 2) in vec4 vertex_color;
+
+out vec2 uv;
+out vec4 color;
+
+void main() {
+    uv = vertex_uv;
+    color = vertex_color;
+    gl_Position = vec4(vertex_position, 0.0f, 1.0f);
+}
@@ -1,8 +1,16 @@
 #version 400
 
+#ifdef UNIFORM_COLOR
+uniform vec4 object_color;
+#else
 in vec3 color;
+#endif
 out vec4 frag_colour;
 
 void main() {
+#ifdef UNIFORM_COLOR
+    frag_colour = object_color;
+#else
     frag_colour = vec4(color, 1.0f);
-}
\ No newline at end of file
+#endif
+}
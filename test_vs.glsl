@@ -1,12 +1,16 @@
 #version 400
+#include "transform.glsl"
+
 layout(location = 0) in vec3 vertex_position;
+#ifndef UNIFORM_COLOR
 layout(location = 1) in vec3 vertex_color;
 
 out vec3 color;
-
-uniform mat4 transform;
+#endif
 
 void main() {
+#ifndef UNIFORM_COLOR
     color = vertex_color;
-    gl_Position = transform * vec4(vertex_position, 1.0f);
-}
\ No newline at end of file
+#endif
+    gl_Position = object_transform() * vec4(vertex_position, 1.0f);
+}
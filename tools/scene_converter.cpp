@@ -0,0 +1,80 @@
+// Offline converter from a text polygon list to a binary scene file.
+// Build from the repository root:
+//   g++ -O2 -std=c++17 tools/scene_converter.cpp utils/scene_file.cpp shapes/mesh.cpp shapes/mesh_optimizer.cpp shapes/simplify.cpp shapes/triangulate.cpp shapes/monotone.cpp utils/predicates.cpp utils/spatial_grid.cpp -o scene_converter
+//
+// Input, one polygon per line, '#' starts a comment:
+//   r g b x0 y0 x1 y1 x2 y2 ...
+
+#include "../shapes/mesh.hpp"
+#include "../shapes/mesh_optimizer.hpp"
+#include "../shapes/simplify.hpp"
+#include "../utils/scene_file.hpp"
+
+#include <stdio.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s polygons.txt level.scene\n", argv[0]);
+        return 1;
+    }
+
+    ifstream input(argv[1]);
+    if (!input) {
+        fprintf(stderr, "ERROR: could not open %s\n", argv[1]);
+        return 1;
+    }
+
+    vector<mesh_data> meshes;
+    double misses_before = 0.0;
+    double misses_after = 0.0;
+    size_t n_triangles = 0;
+    size_t n_levels = 0;
+    string line;
+    int line_number = 0;
+    while (getline(input, line)) {
+        line_number++;
+        line = line.substr(0, line.find('#'));
+        stringstream values(line);
+        float r, g, b;
+        if (!(values >> r >> g >> b)) {
+            continue;
+        }
+        vector<float> vertices;
+        float x, y;
+        while (values >> x >> y) {
+            vertices.push_back(x);
+            vertices.push_back(y);
+            vertices.push_back(0.0f);
+        }
+
+        // Triangulate and simplify here so loading the scene never has to
+        mesh_data mesh = make_polygon_lod_mesh(vertices.data(), vertices.size() / 3, r, g, b);
+        if (mesh.indices.empty()) {
+            fprintf(stderr, "WARNING: skipping polygon on line %i, could not triangulate\n", line_number);
+            continue;
+        }
+
+        // Cache friendly triangle and vertex order, ACMR of the full level is weighted by triangle count below
+        mesh_optimize_stats stats = optimize_mesh(mesh);
+        size_t mesh_triangles = mesh.lods[0].index_count / 3;
+        misses_before += stats.acmr_before * mesh_triangles;
+        misses_after += stats.acmr_after * mesh_triangles;
+        n_triangles += mesh_triangles;
+        n_levels += mesh.lods.size();
+        meshes.push_back(mesh);
+    }
+
+    if (!write_scene_file(argv[2], meshes)) {
+        return 1;
+    }
+    printf("wrote %zu polygons with %zu levels of detail to %s\n", meshes.size(), n_levels, argv[2]);
+    if (n_triangles > 0) {
+        printf("ACMR %.3f before, %.3f after optimizing\n", misses_before / n_triangles, misses_after / n_triangles);
+    }
+    return 0;
+}
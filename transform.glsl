@@ -0,0 +1,15 @@
+// Object to clip space, a mat4 attribute per draw (the indirect command's base instance
+// picks it) or a uniform set for every draw
+#ifdef INSTANCED_TRANSFORM
+layout(location = 2) in mat4 instance_transform;
+
+mat4 object_transform() {
+    return instance_transform;
+}
+#else
+uniform mat4 transform;
+
+mat4 object_transform() {
+    return transform;
+}
+#endif
@@ -0,0 +1,26 @@
+#ifndef AABB_H
+#define AABB_H
+
+// Axis aligned bounding box in the xy plane
+struct aabb {
+    float min_x;
+    float min_y;
+    float max_x;
+    float max_y;
+};
+
+inline bool aabb_overlaps(const aabb& a, const aabb& b) {
+    return a.min_x <= b.max_x && b.min_x <= a.max_x &&
+           a.min_y <= b.max_y && b.min_y <= a.max_y;
+}
+
+inline bool aabb_contains_point(const aabb& box, float x, float y) {
+    return x >= box.min_x && x <= box.max_x && y >= box.min_y && y <= box.max_y;
+}
+
+inline aabb aabb_translate(const aabb& box, float x, float y) {
+    aabb moved = {box.min_x + x, box.min_y + y, box.max_x + x, box.max_y + y};
+    return moved;
+}
+
+#endif
@@ -0,0 +1,427 @@
+#include "aabb_tree.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+static aabb aabb_union(const aabb& a, const aabb& b) {
+    aabb result = {
+        min(a.min_x, b.min_x), min(a.min_y, b.min_y),
+        max(a.max_x, b.max_x), max(a.max_y, b.max_y)
+    };
+    return result;
+}
+
+static bool aabb_contains(const aabb& outer, const aabb& inner) {
+    return outer.min_x <= inner.min_x && outer.min_y <= inner.min_y &&
+           outer.max_x >= inner.max_x && outer.max_y >= inner.max_y;
+}
+
+// In 2D the surface area heuristic becomes a perimeter heuristic
+static float aabb_perimeter(const aabb& box) {
+    return 2.0f * ((box.max_x - box.min_x) + (box.max_y - box.min_y));
+}
+
+// Slab test of the segment p + t * d, t in [0, 1], returns the entry fraction
+static bool segment_hits_aabb(const aabb& box, float x, float y, float dx, float dy, float* fraction) {
+    float t_min = 0.0f;
+    float t_max = 1.0f;
+    float origin[2] = {x, y};
+    float direction[2] = {dx, dy};
+    float box_min[2] = {box.min_x, box.min_y};
+    float box_max[2] = {box.max_x, box.max_y};
+    for (int axis = 0; axis < 2; axis++) {
+        if (fabs(direction[axis]) < 1e-12f) {
+            // Parallel to the slab, must already be inside it
+            if (origin[axis] < box_min[axis] || origin[axis] > box_max[axis]) {
+                return false;
+            }
+            continue;
+        }
+        float inverse = 1.0f / direction[axis];
+        float t1 = (box_min[axis] - origin[axis]) * inverse;
+        float t2 = (box_max[axis] - origin[axis]) * inverse;
+        if (t1 > t2) {
+            swap(t1, t2);
+        }
+        t_min = max(t_min, t1);
+        t_max = min(t_max, t2);
+        if (t_min > t_max) {
+            return false;
+        }
+    }
+    *fraction = t_min;
+    return true;
+}
+
+AABB_TREE::AABB_TREE(float margin) {
+    this->margin = margin;
+    root = -1;
+    free_list = -1;
+}
+
+int AABB_TREE::create_proxy(const aabb& bounds, unsigned int user_id) {
+    int proxy = allocate_node();
+    nodes[proxy].bounds = bounds;
+    nodes[proxy].fat_bounds = {
+        bounds.min_x - margin, bounds.min_y - margin,
+        bounds.max_x + margin, bounds.max_y + margin
+    };
+    nodes[proxy].user_id = user_id;
+    nodes[proxy].height = 0;
+    insert_leaf(proxy);
+    return proxy;
+}
+
+void AABB_TREE::destroy_proxy(int proxy) {
+    remove_leaf(proxy);
+    free_node(proxy);
+}
+
+bool AABB_TREE::move_proxy(int proxy, const aabb& bounds, float dx, float dy) {
+    nodes[proxy].bounds = bounds;
+    if (aabb_contains(nodes[proxy].fat_bounds, bounds)) {
+        // Still inside the fat box, the tree does not change
+        return false;
+    }
+
+    // Fatten again and stretch the box in the direction of motion so a shape
+    // moving steadily does not leave its box on the next step as well
+    aabb fat = {
+        bounds.min_x - margin, bounds.min_y - margin,
+        bounds.max_x + margin, bounds.max_y + margin
+    };
+    if (dx < 0.0f) fat.min_x += 2.0f * dx; else fat.max_x += 2.0f * dx;
+    if (dy < 0.0f) fat.min_y += 2.0f * dy; else fat.max_y += 2.0f * dy;
+
+    remove_leaf(proxy);
+    nodes[proxy].fat_bounds = fat;
+    insert_leaf(proxy);
+    return true;
+}
+
+const aabb& AABB_TREE::get_fat_bounds(int proxy) {
+    return nodes[proxy].fat_bounds;
+}
+
+unsigned int AABB_TREE::get_user_id(int proxy) {
+    return nodes[proxy].user_id;
+}
+
+void AABB_TREE::query(const aabb& box, vector<unsigned int>& result) {
+    result.clear();
+    if (root == -1) {
+        return;
+    }
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty()) {
+        int node = stack.back();
+        stack.pop_back();
+        if (!aabb_overlaps(nodes[node].fat_bounds, box)) {
+            continue;
+        }
+        if (is_leaf(node)) {
+            if (aabb_overlaps(nodes[node].bounds, box)) {
+                result.push_back(nodes[node].user_id);
+            }
+        } else {
+            stack.push_back(nodes[node].child1);
+            stack.push_back(nodes[node].child2);
+        }
+    }
+}
+
+void AABB_TREE::find_pairs(vector<pair<unsigned int, unsigned int>>& pairs) {
+    pairs.clear();
+    if (root == -1) {
+        return;
+    }
+
+    // Query the tree once per leaf, every pair is found from both sides
+    // so only keep it from the leaf with the lower node index
+    for (int leaf = 0; leaf < (int)nodes.size(); leaf++) {
+        if (!is_leaf(leaf)) {
+            continue;
+        }
+        const aabb& box = nodes[leaf].bounds;
+        stack.clear();
+        stack.push_back(root);
+        while (!stack.empty()) {
+            int node = stack.back();
+            stack.pop_back();
+            if (!aabb_overlaps(nodes[node].fat_bounds, box)) {
+                continue;
+            }
+            if (is_leaf(node)) {
+                if (node > leaf && aabb_overlaps(nodes[node].bounds, box)) {
+                    pairs.push_back(make_pair(nodes[leaf].user_id, nodes[node].user_id));
+                }
+            } else {
+                stack.push_back(nodes[node].child1);
+                stack.push_back(nodes[node].child2);
+            }
+        }
+    }
+}
+
+void AABB_TREE::ray_cast(float x1, float y1, float x2, float y2, vector<ray_hit>& hits) {
+    hits.clear();
+    if (root == -1) {
+        return;
+    }
+    float dx = x2 - x1;
+    float dy = y2 - y1;
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty()) {
+        int node = stack.back();
+        stack.pop_back();
+        float fraction;
+        if (!segment_hits_aabb(nodes[node].fat_bounds, x1, y1, dx, dy, &fraction)) {
+            continue;
+        }
+        if (is_leaf(node)) {
+            if (segment_hits_aabb(nodes[node].bounds, x1, y1, dx, dy, &fraction)) {
+                ray_hit hit = {nodes[node].user_id, fraction};
+                hits.push_back(hit);
+            }
+        } else {
+            stack.push_back(nodes[node].child1);
+            stack.push_back(nodes[node].child2);
+        }
+    }
+
+    // Closest hit first
+    sort(hits.begin(), hits.end(), [](const ray_hit& a, const ray_hit& b) {
+        return a.fraction < b.fraction;
+    });
+}
+
+int AABB_TREE::get_height() {
+    if (root == -1) {
+        return 0;
+    }
+    return nodes[root].height;
+}
+
+int AABB_TREE::allocate_node() {
+    if (free_list == -1) {
+        nodes.push_back(tree_node());
+        free_list = nodes.size() - 1;
+        nodes[free_list].parent = -1;
+        nodes[free_list].height = -1;
+    }
+    int node = free_list;
+    free_list = nodes[node].parent;
+    nodes[node].parent = -1;
+    nodes[node].child1 = -1;
+    nodes[node].child2 = -1;
+    nodes[node].height = 0;
+    nodes[node].user_id = 0;
+    return node;
+}
+
+void AABB_TREE::free_node(int node) {
+    nodes[node].parent = free_list;
+    nodes[node].height = -1;
+    free_list = node;
+}
+
+bool AABB_TREE::is_leaf(int node) {
+    return nodes[node].height == 0;
+}
+
+void AABB_TREE::insert_leaf(int leaf) {
+    if (root == -1) {
+        root = leaf;
+        nodes[root].parent = -1;
+        return;
+    }
+
+    // Walk down to the cheapest sibling, cost is the perimeter growth of the tree
+    aabb leaf_box = nodes[leaf].fat_bounds;
+    int index = root;
+    while (!is_leaf(index)) {
+        int child1 = nodes[index].child1;
+        int child2 = nodes[index].child2;
+
+        float area = aabb_perimeter(nodes[index].fat_bounds);
+        float combined_area = aabb_perimeter(aabb_union(nodes[index].fat_bounds, leaf_box));
+
+        // Cost of making a new parent for this node and the new leaf
+        float cost = 2.0f * combined_area;
+        // Minimum cost of pushing the leaf further down the tree
+        float inheritance_cost = 2.0f * (combined_area - area);
+
+        float cost1 = aabb_perimeter(aabb_union(leaf_box, nodes[child1].fat_bounds)) + inheritance_cost;
+        if (!is_leaf(child1)) {
+            cost1 -= aabb_perimeter(nodes[child1].fat_bounds);
+        }
+        float cost2 = aabb_perimeter(aabb_union(leaf_box, nodes[child2].fat_bounds)) + inheritance_cost;
+        if (!is_leaf(child2)) {
+            cost2 -= aabb_perimeter(nodes[child2].fat_bounds);
+        }
+
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+        index = cost1 < cost2 ? child1 : child2;
+    }
+    int sibling = index;
+
+    // Create a new parent for the sibling and the leaf
+    int old_parent = nodes[sibling].parent;
+    int new_parent = allocate_node();
+    nodes[new_parent].parent = old_parent;
+    nodes[new_parent].fat_bounds = aabb_union(leaf_box, nodes[sibling].fat_bounds);
+    nodes[new_parent].height = nodes[sibling].height + 1;
+    nodes[new_parent].child1 = sibling;
+    nodes[new_parent].child2 = leaf;
+    nodes[sibling].parent = new_parent;
+    nodes[leaf].parent = new_parent;
+
+    if (old_parent == -1) {
+        root = new_parent;
+    } else if (nodes[old_parent].child1 == sibling) {
+        nodes[old_parent].child1 = new_parent;
+    } else {
+        nodes[old_parent].child2 = new_parent;
+    }
+
+    // Refit and rebalance the ancestors
+    index = nodes[leaf].parent;
+    while (index != -1) {
+        index = balance(index);
+        int child1 = nodes[index].child1;
+        int child2 = nodes[index].child2;
+        nodes[index].height = 1 + max(nodes[child1].height, nodes[child2].height);
+        nodes[index].fat_bounds = aabb_union(nodes[child1].fat_bounds, nodes[child2].fat_bounds);
+        index = nodes[index].parent;
+    }
+}
+
+void AABB_TREE::remove_leaf(int leaf) {
+    if (leaf == root) {
+        root = -1;
+        return;
+    }
+
+    // The sibling takes the place of the parent
+    int parent = nodes[leaf].parent;
+    int grand_parent = nodes[parent].parent;
+    int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grand_parent == -1) {
+        root = sibling;
+        nodes[sibling].parent = -1;
+        free_node(parent);
+        return;
+    }
+
+    if (nodes[grand_parent].child1 == parent) {
+        nodes[grand_parent].child1 = sibling;
+    } else {
+        nodes[grand_parent].child2 = sibling;
+    }
+    nodes[sibling].parent = grand_parent;
+    free_node(parent);
+
+    int index = grand_parent;
+    while (index != -1) {
+        index = balance(index);
+        int child1 = nodes[index].child1;
+        int child2 = nodes[index].child2;
+        nodes[index].fat_bounds = aabb_union(nodes[child1].fat_bounds, nodes[child2].fat_bounds);
+        nodes[index].height = 1 + max(nodes[child1].height, nodes[child2].height);
+        index = nodes[index].parent;
+    }
+}
+
+// Rotate the subtree at node A when one child is more than one level taller.
+// Returns the node that is now at the position of A.
+int AABB_TREE::balance(int a) {
+    if (is_leaf(a) || nodes[a].height < 2) {
+        return a;
+    }
+
+    int b = nodes[a].child1;
+    int c = nodes[a].child2;
+    int height_difference = nodes[c].height - nodes[b].height;
+
+    // Rotate C up
+    if (height_difference > 1) {
+        int f = nodes[c].child1;
+        int g = nodes[c].child2;
+
+        nodes[c].child1 = a;
+        nodes[c].parent = nodes[a].parent;
+        nodes[a].parent = c;
+
+        if (nodes[c].parent == -1) {
+            root = c;
+        } else if (nodes[nodes[c].parent].child1 == a) {
+            nodes[nodes[c].parent].child1 = c;
+        } else {
+            nodes[nodes[c].parent].child2 = c;
+        }
+
+        // Keep the taller grandchild below C
+        if (nodes[f].height > nodes[g].height) {
+            nodes[c].child2 = f;
+            nodes[a].child2 = g;
+            nodes[g].parent = a;
+            nodes[a].fat_bounds = aabb_union(nodes[b].fat_bounds, nodes[g].fat_bounds);
+            nodes[c].fat_bounds = aabb_union(nodes[a].fat_bounds, nodes[f].fat_bounds);
+            nodes[a].height = 1 + max(nodes[b].height, nodes[g].height);
+            nodes[c].height = 1 + max(nodes[a].height, nodes[f].height);
+        } else {
+            nodes[c].child2 = g;
+            nodes[a].child2 = f;
+            nodes[f].parent = a;
+            nodes[a].fat_bounds = aabb_union(nodes[b].fat_bounds, nodes[f].fat_bounds);
+            nodes[c].fat_bounds = aabb_union(nodes[a].fat_bounds, nodes[g].fat_bounds);
+            nodes[a].height = 1 + max(nodes[b].height, nodes[f].height);
+            nodes[c].height = 1 + max(nodes[a].height, nodes[g].height);
+        }
+        return c;
+    }
+
+    // Rotate B up
+    if (height_difference < -1) {
+        int d = nodes[b].child1;
+        int e = nodes[b].child2;
+
+        nodes[b].child1 = a;
+        nodes[b].parent = nodes[a].parent;
+        nodes[a].parent = b;
+
+        if (nodes[b].parent == -1) {
+            root = b;
+        } else if (nodes[nodes[b].parent].child1 == a) {
+            nodes[nodes[b].parent].child1 = b;
+        } else {
+            nodes[nodes[b].parent].child2 = b;
+        }
+
+        if (nodes[d].height > nodes[e].height) {
+            nodes[b].child2 = d;
+            nodes[a].child1 = e;
+            nodes[e].parent = a;
+            nodes[a].fat_bounds = aabb_union(nodes[c].fat_bounds, nodes[e].fat_bounds);
+            nodes[b].fat_bounds = aabb_union(nodes[a].fat_bounds, nodes[d].fat_bounds);
+            nodes[a].height = 1 + max(nodes[c].height, nodes[e].height);
+            nodes[b].height = 1 + max(nodes[a].height, nodes[d].height);
+        } else {
+            nodes[b].child2 = e;
+            nodes[a].child1 = d;
+            nodes[d].parent = a;
+            nodes[a].fat_bounds = aabb_union(nodes[c].fat_bounds, nodes[d].fat_bounds);
+            nodes[b].fat_bounds = aabb_union(nodes[a].fat_bounds, nodes[e].fat_bounds);
+            nodes[a].height = 1 + max(nodes[c].height, nodes[d].height);
+            nodes[b].height = 1 + max(nodes[a].height, nodes[e].height);
+        }
+        return b;
+    }
+
+    return a;
+}
@@ -0,0 +1,57 @@
+#ifndef AABB_TREE_H
+#define AABB_TREE_H
+
+#include "aabb.hpp"
+
+#include <vector>
+#include <utility>
+using namespace std;
+
+struct ray_hit {
+    unsigned int user_id;
+    float fraction; // 0 at the segment start, 1 at the end
+};
+
+// Dynamic bounding volume tree for broad phase overlap tests between shapes.
+// Leaves store a fattened box, so small moves do not touch the tree at all,
+// larger moves remove and reinsert the leaf which refits the ancestors.
+// The tree is kept balanced with rotations, like the AVL trees it borrows from.
+class AABB_TREE {
+    public:
+        AABB_TREE(float margin);
+        int create_proxy(const aabb& bounds, unsigned int user_id);
+        void destroy_proxy(int proxy);
+        bool move_proxy(int proxy, const aabb& bounds, float dx, float dy);
+        const aabb& get_fat_bounds(int proxy);
+        unsigned int get_user_id(int proxy);
+        void query(const aabb& box, vector<unsigned int>& result);
+        void find_pairs(vector<pair<unsigned int, unsigned int>>& pairs);
+        void ray_cast(float x1, float y1, float x2, float y2, vector<ray_hit>& hits);
+        int get_height();
+
+    private:
+        struct tree_node {
+            aabb fat_bounds;
+            aabb bounds; // Tight bounds, only used by leaves
+            int parent; // Next free node while the node is unused
+            int child1;
+            int child2;
+            int height; // Leaf = 0, free node = -1
+            unsigned int user_id;
+        };
+
+        float margin;
+        int root;
+        int free_list;
+        vector<tree_node> nodes;
+        vector<int> stack;
+
+        int allocate_node();
+        void free_node(int node);
+        void insert_leaf(int leaf);
+        void remove_leaf(int leaf);
+        int balance(int node);
+        bool is_leaf(int node);
+};
+
+#endif
@@ -0,0 +1,113 @@
+#include "buddy_allocator.hpp"
+
+BUDDY_ALLOCATOR::BUDDY_ALLOCATOR(size_t capacity, size_t min_block) {
+    // The whole range has to be one block, so round the capacity up to a power of two blocks
+    this->min_block = min_block ? min_block : 1;
+    max_order = 0;
+    while ((this->min_block << max_order) < capacity) {
+        max_order++;
+    }
+    this->capacity = this->min_block << max_order;
+    requested_size = 0;
+    allocated_size = 0;
+
+    free_blocks.resize(max_order + 1);
+    free_blocks[max_order].insert(0);
+}
+
+size_t BUDDY_ALLOCATOR::allocate(size_t size) {
+    if (size == 0 || size > capacity) {
+        return BUDDY_INVALID_OFFSET;
+    }
+
+    unsigned int order = 0;
+    while ((min_block << order) < size) {
+        order++;
+    }
+
+    // Smallest free block that fits, lowest offset first keeps the range packed at the start
+    unsigned int found = order;
+    while (found <= max_order && free_blocks[found].empty()) {
+        found++;
+    }
+    if (found > max_order) {
+        return BUDDY_INVALID_OFFSET;
+    }
+    size_t offset = *free_blocks[found].begin();
+    free_blocks[found].erase(free_blocks[found].begin());
+
+    // Split it down, the upper halves go back on the free lists
+    while (found > order) {
+        found--;
+        free_blocks[found].insert(offset + (min_block << found));
+    }
+
+    allocation block;
+    block.order = order;
+    block.requested = size;
+    allocations[offset] = block;
+    requested_size += size;
+    allocated_size += min_block << order;
+    return offset;
+}
+
+void BUDDY_ALLOCATOR::free(size_t offset) {
+    unordered_map<size_t, allocation>::iterator it = allocations.find(offset);
+    if (it == allocations.end()) {
+        return;
+    }
+    unsigned int order = it->second.order;
+    requested_size -= it->second.requested;
+    allocated_size -= min_block << order;
+    allocations.erase(it);
+
+    // Merge with the buddy for as long as it is free too
+    while (order < max_order) {
+        size_t buddy = offset ^ (min_block << order);
+        set<size_t>::iterator buddy_it = free_blocks[order].find(buddy);
+        if (buddy_it == free_blocks[order].end()) {
+            break;
+        }
+        free_blocks[order].erase(buddy_it);
+        offset = offset < buddy ? offset : buddy;
+        order++;
+    }
+    free_blocks[order].insert(offset);
+}
+
+size_t BUDDY_ALLOCATOR::get_capacity() {
+    return capacity;
+}
+
+size_t BUDDY_ALLOCATOR::get_block_size(size_t offset) {
+    unordered_map<size_t, allocation>::iterator it = allocations.find(offset);
+    if (it == allocations.end()) {
+        return 0;
+    }
+    return min_block << it->second.order;
+}
+
+size_t BUDDY_ALLOCATOR::get_requested_size() {
+    return requested_size;
+}
+
+size_t BUDDY_ALLOCATOR::get_allocated_size() {
+    return allocated_size;
+}
+
+size_t BUDDY_ALLOCATOR::get_free_size() {
+    return capacity - allocated_size;
+}
+
+size_t BUDDY_ALLOCATOR::get_largest_free_block() {
+    for (int order = max_order; order >= 0; order--) {
+        if (!free_blocks[order].empty()) {
+            return min_block << order;
+        }
+    }
+    return 0;
+}
+
+unsigned int BUDDY_ALLOCATOR::get_allocation_count() {
+    return allocations.size();
+}
@@ -0,0 +1,43 @@
+#ifndef BUDDY_ALLOCATOR_H
+#define BUDDY_ALLOCATOR_H
+
+#include <stddef.h>
+#include <set>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+#define BUDDY_INVALID_OFFSET ((size_t)-1)
+
+// Binary buddy allocator over an abstract range of units (bytes, vertices, indices).
+// It does not touch any memory itself, so it can manage a GL buffer or be tested without GL.
+// Blocks are powers of two times the minimum block, freeing merges a block with its buddy.
+class BUDDY_ALLOCATOR {
+    public:
+        BUDDY_ALLOCATOR(size_t capacity, size_t min_block);
+        size_t allocate(size_t size);
+        void free(size_t offset);
+        size_t get_capacity();
+        size_t get_block_size(size_t offset);
+        size_t get_requested_size();
+        size_t get_allocated_size();
+        size_t get_free_size();
+        size_t get_largest_free_block();
+        unsigned int get_allocation_count();
+
+    private:
+        struct allocation {
+            unsigned int order;
+            size_t requested;
+        };
+
+        size_t capacity;
+        size_t min_block;
+        unsigned int max_order;
+        size_t requested_size;
+        size_t allocated_size;
+        vector<set<size_t>> free_blocks; // Free block offsets per order
+        unordered_map<size_t, allocation> allocations;
+};
+
+#endif
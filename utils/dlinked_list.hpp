@@ -9,6 +9,7 @@ struct dlinked {
     float x;
     float y;
     float z;
+    int index; // Position of the vertex in the original array
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+#include "frame_pacer.hpp"
+
+#include <cmath>
+using namespace std;
+
+// Sleeps are only trusted up to this close to the deadline, the rest is spun
+#define SPIN_MARGIN 0.002
+// Safety margin before the vblank in late latch mode
+#define LATCH_MARGIN 0.001
+
+FRAME_PACER::FRAME_PACER(frame_pacing_mode mode, double refresh_rate) {
+    refresh_period = 1.0 / refresh_rate;
+    target_period = refresh_period;
+    next_deadline = 0.0;
+    frame_start = 0.0;
+    work_estimate = 0.0;
+    last_present = 0.0;
+    n_intervals = 0;
+    next_interval = 0;
+    set_mode(mode);
+}
+
+void FRAME_PACER::set_mode(frame_pacing_mode mode) {
+    this->mode = mode;
+    glfwSwapInterval(mode == PACING_VSYNC || mode == PACING_LATE_LATCH ? 1 : 0);
+    next_deadline = 0.0;
+    n_intervals = 0;
+    next_interval = 0;
+}
+
+void FRAME_PACER::set_target_fps(double target_fps) {
+    target_period = 1.0 / target_fps;
+    next_deadline = 0.0;
+}
+
+frame_pacing_mode FRAME_PACER::get_mode() {
+    return mode;
+}
+
+const char* FRAME_PACER::get_mode_name() {
+    switch (mode) {
+        case PACING_VSYNC: return "vsync";
+        case PACING_UNCAPPED: return "uncapped";
+        case PACING_TARGET_FPS: return "target fps";
+        case PACING_LATE_LATCH: return "late latch";
+    }
+    return "unknown";
+}
+
+void FRAME_PACER::wait_for_frame() {
+    double now = glfwGetTime();
+    if (mode == PACING_TARGET_FPS) {
+        if (next_deadline == 0.0 || now > next_deadline + target_period) {
+            // First frame or we fell far behind, restart the schedule instead of rushing to catch up
+            next_deadline = now;
+        }
+        sleep_until(next_deadline);
+        next_deadline += target_period;
+    } else if (mode == PACING_LATE_LATCH && last_present > 0.0) {
+        // The swap returns right after a vblank, so the next one is a period later.
+        // Wake up just early enough for the work of one frame.
+        double next_vblank = last_present + refresh_period;
+        while (next_vblank - work_estimate - LATCH_MARGIN < now) {
+            next_vblank += refresh_period;
+        }
+        sleep_until(next_vblank - work_estimate - LATCH_MARGIN);
+    }
+    frame_start = glfwGetTime();
+}
+
+// Right before glfwSwapBuffers, the swap can block until the vblank and that part is not work
+void FRAME_PACER::frame_submitted() {
+    double work = glfwGetTime() - frame_start;
+    work_estimate = work_estimate == 0.0 ? work : work_estimate * 0.9 + work * 0.1;
+}
+
+void FRAME_PACER::frame_presented() {
+    double now = glfwGetTime();
+
+    if (last_present > 0.0) {
+        intervals[next_interval] = now - last_present;
+        next_interval = (next_interval + 1) % PACING_HISTORY;
+        if (n_intervals < PACING_HISTORY) {
+            n_intervals++;
+        }
+    }
+    last_present = now;
+}
+
+double FRAME_PACER::get_average_frame_time() {
+    if (n_intervals == 0) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (int i = 0; i < n_intervals; i++) {
+        sum += intervals[i];
+    }
+    return sum / n_intervals;
+}
+
+// The frame time being aimed for, the target in target fps mode and the refresh period otherwise.
+// Uncapped has no aim, the refresh period is still a sensible budget for the resolution scaler.
+double FRAME_PACER::get_frame_period() {
+    return mode == PACING_TARGET_FPS ? target_period : refresh_period;
+}
+
+double FRAME_PACER::get_jitter() {
+    // Standard deviation of the time between presents
+    if (n_intervals < 2) {
+        return 0.0;
+    }
+    double average = get_average_frame_time();
+    double sum = 0.0;
+    for (int i = 0; i < n_intervals; i++) {
+        sum += (intervals[i] - average) * (intervals[i] - average);
+    }
+    return sqrt(sum / (n_intervals - 1));
+}
+
+// Input callbacks stamp events when GLFW delivers them, so events are delivered all through
+// the wait. Otherwise everything that arrived during the wait would get the time of the next poll.
+void FRAME_PACER::sleep_until(double time) {
+    // Sleep most of the way, the OS may oversleep by a millisecond or more. Events wake it up early
+    double remaining = time - glfwGetTime();
+    while (remaining > SPIN_MARGIN) {
+        glfwWaitEventsTimeout(remaining - SPIN_MARGIN);
+        remaining = time - glfwGetTime();
+    }
+    // Spin the rest for precision
+    while (glfwGetTime() < time) {
+        glfwPollEvents();
+    }
+}
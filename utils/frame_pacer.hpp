@@ -0,0 +1,51 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+enum frame_pacing_mode {
+    PACING_VSYNC, // Swap interval 1, the driver blocks in glfwSwapBuffers
+    PACING_UNCAPPED, // Swap interval 0, as fast as possible
+    PACING_TARGET_FPS, // Swap interval 0, sleep then spin to hit the target frame time
+    PACING_LATE_LATCH, // Swap interval 1, start the frame as late as possible before the next vblank
+};
+
+#define PACING_HISTORY 128
+
+// Decides when a frame starts. wait_for_frame goes at the top of the loop, before
+// input is polled, so in late latch mode input is sampled just before the swap.
+// frame_submitted goes right before glfwSwapBuffers and frame_presented right after it.
+// While waiting it delivers GLFW events as they arrive, so their timestamps are accurate.
+// Events during the work of a frame or a blocking swap are stamped at the next poll.
+class FRAME_PACER {
+    public:
+        // The target fps starts at the refresh rate
+        FRAME_PACER(frame_pacing_mode mode, double refresh_rate);
+        void set_mode(frame_pacing_mode mode);
+        void set_target_fps(double target_fps);
+        frame_pacing_mode get_mode();
+        const char* get_mode_name();
+        void wait_for_frame();
+        void frame_submitted();
+        void frame_presented();
+        double get_average_frame_time();
+        double get_frame_period();
+        double get_jitter();
+
+    private:
+        frame_pacing_mode mode;
+        double refresh_period; // Time between vblanks, late latch aims for these
+        double target_period; // Frame time in target fps mode
+        double next_deadline;
+        double frame_start;
+        double work_estimate; // Smoothed time from wake up to submitting the swap
+        double last_present;
+        double intervals[PACING_HISTORY]; // Time between presents
+        int n_intervals;
+        int next_interval;
+
+        void sleep_until(double time);
+};
+
+#endif
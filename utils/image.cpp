@@ -0,0 +1,133 @@
+#include "image.hpp"
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdlib.h>
+
+// Next whitespace separated token of a netpbm header, skipping comments
+static bool read_token(FILE* file, char* token, int max_length) {
+    int c = fgetc(file);
+    while (c != EOF && (isspace(c) || c == '#')) {
+        if (c == '#') {
+            while (c != EOF && c != '\n') {
+                c = fgetc(file);
+            }
+        }
+        c = fgetc(file);
+    }
+    int length = 0;
+    while (c != EOF && !isspace(c) && length < max_length - 1) {
+        token[length++] = c;
+        c = fgetc(file);
+    }
+    token[length] = '\0';
+    return length > 0;
+}
+
+// PAM headers are keyword lines up to ENDHDR
+static bool read_pam_header(FILE* file, int* width, int* height, int* depth, int* max_value) {
+    char token[64];
+    *width = *height = *depth = *max_value = 0;
+    while (read_token(file, token, sizeof(token))) {
+        if (strcmp(token, "ENDHDR") == 0) {
+            return true;
+        }
+        char value[64];
+        if (!read_token(file, value, sizeof(value))) {
+            return false;
+        }
+        if (strcmp(token, "WIDTH") == 0) {
+            *width = atoi(value);
+        } else if (strcmp(token, "HEIGHT") == 0) {
+            *height = atoi(value);
+        } else if (strcmp(token, "DEPTH") == 0) {
+            *depth = atoi(value);
+        } else if (strcmp(token, "MAXVAL") == 0) {
+            *max_value = atoi(value);
+        }
+        // TUPLTYPE is implied by the depth
+    }
+    return false;
+}
+
+bool load_image(const char* path, image& result) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "ERROR: could not open image %s\n", path);
+        return false;
+    }
+
+    char magic[8];
+    int width = 0, height = 0, depth = 0, max_value = 0;
+    bool header_ok = read_token(file, magic, sizeof(magic));
+    if (header_ok && strcmp(magic, "P7") == 0) {
+        header_ok = read_pam_header(file, &width, &height, &depth, &max_value);
+    } else if (header_ok && (strcmp(magic, "P5") == 0 || strcmp(magic, "P6") == 0)) {
+        char token[32];
+        depth = magic[1] == '5' ? 1 : 3;
+        header_ok = read_token(file, token, sizeof(token)) && (width = atoi(token)) &&
+            read_token(file, token, sizeof(token)) && (height = atoi(token)) &&
+            read_token(file, token, sizeof(token)) && (max_value = atoi(token));
+        // read_token ate the single whitespace byte before the pixels
+    } else {
+        header_ok = false;
+    }
+    if (!header_ok || width <= 0 || height <= 0 || depth < 1 || depth > 4 || max_value != 255) {
+        fprintf(stderr, "ERROR: %s is not an 8 bit P5, P6 or P7 image\n", path);
+        fclose(file);
+        return false;
+    }
+
+    vector<unsigned char> raw((size_t)width * height * depth);
+    if (fread(raw.data(), 1, raw.size(), file) != raw.size()) {
+        fprintf(stderr, "ERROR: image %s is truncated\n", path);
+        fclose(file);
+        return false;
+    }
+    fclose(file);
+
+    result.width = width;
+    result.height = height;
+    result.pixels.resize((size_t)width * height * 4);
+    for (size_t i = 0; i < (size_t)width * height; i++) {
+        const unsigned char* source = &raw[i * depth];
+        unsigned char* target = &result.pixels[i * 4];
+        if (depth <= 2) {
+            target[0] = target[1] = target[2] = source[0];
+            target[3] = depth == 2 ? source[1] : 255;
+        } else {
+            target[0] = source[0];
+            target[1] = source[1];
+            target[2] = source[2];
+            target[3] = depth == 4 ? source[3] : 255;
+        }
+    }
+    return true;
+}
+
+bool save_image(const char* path, const image& source) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "ERROR: could not write image %s\n", path);
+        return false;
+    }
+    fprintf(file, "P7\nWIDTH %i\nHEIGHT %i\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n", source.width, source.height);
+    bool ok = fwrite(source.pixels.data(), 1, source.pixels.size(), file) == source.pixels.size();
+    fclose(file);
+    return ok;
+}
+
+image make_image(int width, int height, unsigned char r, unsigned char g, unsigned char b, unsigned char a) {
+    image result;
+    result.width = width;
+    result.height = height;
+    result.pixels.resize((size_t)width * height * 4);
+    for (size_t i = 0; i < (size_t)width * height; i++) {
+        result.pixels[i * 4] = r;
+        result.pixels[i * 4 + 1] = g;
+        result.pixels[i * 4 + 2] = b;
+        result.pixels[i * 4 + 3] = a;
+    }
+    return result;
+}
@@ -0,0 +1,21 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include <vector>
+using namespace std;
+
+// 8 bit RGBA, rows from the top down
+struct image {
+    int width;
+    int height;
+    vector<unsigned char> pixels;
+};
+
+// Binary netpbm files, so there is no image library to depend on:
+// P5 (grey), P6 (RGB) and P7 (PAM, with TUPLTYPE GRAYSCALE, RGB or the _ALPHA variants).
+// Everything is converted to RGBA, without alpha it is opaque.
+bool load_image(const char* path, image& result);
+bool save_image(const char* path, const image& source);
+image make_image(int width, int height, unsigned char r, unsigned char g, unsigned char b, unsigned char a);
+
+#endif
@@ -0,0 +1,93 @@
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+#include "input.hpp"
+
+#include <string.h>
+
+INPUT_QUEUE::INPUT_QUEUE() {
+    head = 0;
+    tail = 0;
+    dropped = 0;
+}
+
+bool INPUT_QUEUE::push(const input_event& event) {
+    unsigned int current_tail = tail.load(memory_order_relaxed);
+    if (current_tail - head.load(memory_order_acquire) == INPUT_QUEUE_SIZE) {
+        // Full, the consumer has not been running for a long time
+        dropped++;
+        return false;
+    }
+    events[current_tail & (INPUT_QUEUE_SIZE - 1)] = event;
+    tail.store(current_tail + 1, memory_order_release);
+    return true;
+}
+
+bool INPUT_QUEUE::pop_until(double time, input_event& event) {
+    unsigned int current_head = head.load(memory_order_relaxed);
+    if (current_head == tail.load(memory_order_acquire)) {
+        return false;
+    }
+    const input_event& next = events[current_head & (INPUT_QUEUE_SIZE - 1)];
+    if (next.time > time) {
+        return false;
+    }
+    event = next;
+    head.store(current_head + 1, memory_order_release);
+    return true;
+}
+
+unsigned int INPUT_QUEUE::get_dropped_count() {
+    return dropped;
+}
+
+INPUT_STATE::INPUT_STATE() {
+    memset(keys, 0, sizeof(keys));
+    cursor_x = 0.0;
+    cursor_y = 0.0;
+}
+
+void INPUT_STATE::apply(const input_event& event) {
+    if (event.type == INPUT_KEY && event.key >= 0 && event.key <= GLFW_KEY_LAST) {
+        // Repeats keep the key down
+        keys[event.key] = event.action != GLFW_RELEASE;
+    } else if (event.type == INPUT_CURSOR) {
+        cursor_x = event.x;
+        cursor_y = event.y;
+    }
+}
+
+bool INPUT_STATE::is_down(int key) {
+    return keys[key];
+}
+
+static void push_event(GLFWwindow* window, input_event_type type, int key, int action, double x, double y) {
+    INPUT_QUEUE* queue = (INPUT_QUEUE*)glfwGetWindowUserPointer(window);
+    input_event event;
+    event.type = type;
+    event.time = glfwGetTime();
+    event.key = key;
+    event.action = action;
+    event.x = x;
+    event.y = y;
+    queue->push(event);
+}
+
+static void glfw_key_callback(GLFWwindow* window, int key, int /* scancode */, int action, int /* mods */) {
+    push_event(window, INPUT_KEY, key, action, 0.0, 0.0);
+}
+
+static void glfw_cursor_position_callback(GLFWwindow* window, double x, double y) {
+    push_event(window, INPUT_CURSOR, -1, 0, x, y);
+}
+
+static void glfw_mouse_button_callback(GLFWwindow* window, int button, int action, int /* mods */) {
+    push_event(window, INPUT_MOUSE_BUTTON, button, action, 0.0, 0.0);
+}
+
+void install_input_callbacks(GLFWwindow* window, INPUT_QUEUE* queue) {
+    glfwSetWindowUserPointer(window, queue);
+    glfwSetKeyCallback(window, glfw_key_callback);
+    glfwSetCursorPosCallback(window, glfw_cursor_position_callback);
+    glfwSetMouseButtonCallback(window, glfw_mouse_button_callback);
+}
@@ -0,0 +1,61 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <glad/glad.h> // Include before GLFW
+#include <GLFW/glfw3.h>
+
+#include <atomic>
+using namespace std;
+
+enum input_event_type {
+    INPUT_KEY,
+    INPUT_CURSOR,
+    INPUT_MOUSE_BUTTON,
+};
+
+struct input_event {
+    input_event_type type;
+    double time; // glfwGetTime() when GLFW delivered the event
+    int key; // GLFW key or mouse button
+    int action; // GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT
+    double x; // Cursor position in screen coordinates
+    double y;
+};
+
+// Fixed size single producer, single consumer queue without locks. GLFW callbacks
+// push, the simulation pops, so events are handled at the time they happened
+// instead of whatever the key state is once per frame.
+#define INPUT_QUEUE_SIZE 1024 // Must be a power of two
+
+class INPUT_QUEUE {
+    public:
+        INPUT_QUEUE();
+        bool push(const input_event& event);
+        bool pop_until(double time, input_event& event);
+        unsigned int get_dropped_count();
+
+    private:
+        input_event events[INPUT_QUEUE_SIZE];
+        atomic<unsigned int> head; // Next event to read, only written by the consumer
+        atomic<unsigned int> tail; // Next free slot, only written by the producer
+        atomic<unsigned int> dropped;
+};
+
+// Which keys are held, built up from the events
+class INPUT_STATE {
+    public:
+        INPUT_STATE();
+        void apply(const input_event& event);
+        bool is_down(int key);
+        double cursor_x;
+        double cursor_y;
+
+    private:
+        bool keys[GLFW_KEY_LAST + 1];
+};
+
+// Sets the GLFW key, cursor and mouse button callbacks to fill the queue.
+// Uses the window user pointer.
+void install_input_callbacks(GLFWwindow* window, INPUT_QUEUE* queue);
+
+#endif
@@ -0,0 +1,253 @@
+#include "job_system.hpp"
+
+// Index of the queue owned by the current thread when it is a worker
+static thread_local int current_queue = -1;
+
+JOB_SYSTEM::JOB_SYSTEM(unsigned int n_workers) {
+    if (n_workers == 0) {
+        // Leave a core for the main thread, it helps out while waiting anyway
+        unsigned int cores = thread::hardware_concurrency();
+        n_workers = cores > 1 ? cores - 1 : 1;
+    }
+    queued_jobs = 0;
+    waiters = 0;
+    stopping = false;
+    main_thread_id = this_thread::get_id();
+    for (unsigned int i = 0; i < n_workers + 2; i++) {
+        queues.push_back(unique_ptr<worker_queue>(new worker_queue));
+    }
+    for (unsigned int i = 0; i < n_workers; i++) {
+        workers.push_back(thread(&JOB_SYSTEM::worker_loop, this, i));
+    }
+}
+
+JOB_SYSTEM::~JOB_SYSTEM() {
+    {
+        lock_guard<mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wake_up.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+job_handle JOB_SYSTEM::create_job(function<void()> work) {
+    job_handle new_job = make_shared<job>();
+    new_job->work = work;
+    // The extra count is released by submit, so dependencies can be added until then
+    new_job->unfinished_dependencies = 1;
+    new_job->done = false;
+    new_job->main_thread = false;
+    return new_job;
+}
+
+job_handle JOB_SYSTEM::create_main_thread_job(function<void()> work) {
+    job_handle new_job = create_job(work);
+    new_job->main_thread = true;
+    return new_job;
+}
+
+void JOB_SYSTEM::add_dependency(job_handle job, job_handle depends_on) {
+    lock_guard<mutex> lock(depends_on->dependents_mutex);
+    if (depends_on->done) {
+        return;
+    }
+    job->unfinished_dependencies++;
+    depends_on->dependents.push_back(job);
+}
+
+void JOB_SYSTEM::submit(job_handle job) {
+    if (--job->unfinished_dependencies == 0) {
+        push_ready(job);
+    }
+}
+
+job_handle JOB_SYSTEM::run(function<void()> work) {
+    job_handle new_job = create_job(work);
+    submit(new_job);
+    return new_job;
+}
+
+void JOB_SYSTEM::wait(job_handle job) {
+    // Help out instead of blocking, this is also what keeps nested waits from deadlocking
+    bool worker = current_queue >= 0;
+    bool main_thread = this_thread::get_id() == main_thread_id;
+    unsigned int index = get_queue_index();
+    while (!job->done) {
+        job_handle next = pop_or_steal(index, worker);
+        if (next) {
+            execute(next);
+            continue;
+        }
+        if (main_thread) {
+            // The job may depend on GL work, which only this thread can do
+            run_main_thread_jobs();
+        }
+
+        // Nothing to help with, sleep until a job finishes (or there is something to run)
+        waiters++;
+        {
+            unique_lock<mutex> lock(sleep_mutex);
+            job_finished.wait(lock, [&] {
+                if (job->done || (worker && queued_jobs > 0)) {
+                    return true;
+                }
+                if (main_thread) {
+                    lock_guard<mutex> main_lock(main_mutex);
+                    return !main_jobs.empty();
+                }
+                return false;
+            });
+        }
+        waiters--;
+    }
+}
+
+void JOB_SYSTEM::parallel_for(unsigned int begin, unsigned int end, unsigned int grain_size,
+    function<void(unsigned int, unsigned int)> work) {
+        if (begin >= end) {
+            return;
+        }
+        if (grain_size == 0) {
+            grain_size = 1;
+        }
+        if (end - begin <= grain_size) {
+            work(begin, end);
+            return;
+        }
+
+        vector<job_handle> jobs;
+        for (unsigned int first = begin; first < end; first += grain_size) {
+            unsigned int last = min(first + grain_size, end);
+            jobs.push_back(run([work, first, last] { work(first, last); }));
+        }
+        for (job_handle& job : jobs) {
+            wait(job);
+        }
+}
+
+void JOB_SYSTEM::run_main_thread_jobs() {
+    while (true) {
+        job_handle next;
+        {
+            lock_guard<mutex> lock(main_mutex);
+            if (main_jobs.empty()) {
+                return;
+            }
+            next = main_jobs.front();
+            main_jobs.pop_front();
+        }
+        execute(next);
+    }
+}
+
+unsigned int JOB_SYSTEM::get_worker_count() {
+    return workers.size();
+}
+
+void JOB_SYSTEM::worker_loop(unsigned int index) {
+    current_queue = index;
+    while (true) {
+        job_handle next = pop_or_steal(index, true);
+        if (next) {
+            execute(next);
+            continue;
+        }
+
+        unique_lock<mutex> lock(sleep_mutex);
+        wake_up.wait(lock, [this] { return stopping || queued_jobs > 0; });
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+unsigned int JOB_SYSTEM::get_queue_index() {
+    if (current_queue >= 0) {
+        return current_queue;
+    }
+    return this_thread::get_id() == main_thread_id ? workers.size() : workers.size() + 1;
+}
+
+void JOB_SYSTEM::push_ready(job_handle job) {
+    if (job->main_thread) {
+        {
+            lock_guard<mutex> lock(main_mutex);
+            main_jobs.push_back(job);
+        }
+        notify_waiters();
+        return;
+    }
+
+    unsigned int index = get_queue_index();
+    {
+        lock_guard<mutex> lock(queues[index]->queue_mutex);
+        queues[index]->jobs.push_back(job);
+    }
+    {
+        lock_guard<mutex> lock(sleep_mutex);
+        queued_jobs++;
+    }
+    wake_up.notify_one();
+    notify_waiters();
+}
+
+void JOB_SYSTEM::notify_waiters() {
+    if (waiters == 0) {
+        return;
+    }
+    // Taking the lock makes sure a waiter is either still checking or already asleep
+    {
+        lock_guard<mutex> lock(sleep_mutex);
+    }
+    job_finished.notify_all();
+}
+
+job_handle JOB_SYSTEM::pop_or_steal(unsigned int index, bool steal) {
+    // Newest job of our own queue first, it is most likely still in cache
+    {
+        lock_guard<mutex> lock(queues[index]->queue_mutex);
+        if (!queues[index]->jobs.empty()) {
+            job_handle next = queues[index]->jobs.back();
+            queues[index]->jobs.pop_back();
+            queued_jobs--;
+            return next;
+        }
+    }
+    if (!steal) {
+        return job_handle();
+    }
+    // Oldest job of somebody else, those tend to be the big ones
+    for (unsigned int i = 1; i < queues.size(); i++) {
+        worker_queue& victim = *queues[(index + i) % queues.size()];
+        lock_guard<mutex> lock(victim.queue_mutex);
+        if (!victim.jobs.empty()) {
+            job_handle next = victim.jobs.front();
+            victim.jobs.pop_front();
+            queued_jobs--;
+            return next;
+        }
+    }
+    return job_handle();
+}
+
+void JOB_SYSTEM::execute(job_handle job) {
+    job->work();
+
+    vector<job_handle> ready;
+    {
+        lock_guard<mutex> lock(job->dependents_mutex);
+        job->done = true;
+        for (job_handle& dependent : job->dependents) {
+            if (--dependent->unfinished_dependencies == 0) {
+                ready.push_back(dependent);
+            }
+        }
+        job->dependents.clear();
+    }
+    for (job_handle& next : ready) {
+        push_ready(next);
+    }
+    notify_waiters();
+}
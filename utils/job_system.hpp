@@ -0,0 +1,74 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+struct job {
+    function<void()> work;
+    atomic<int> unfinished_dependencies;
+    atomic<bool> done;
+    bool main_thread; // GL calls, only run from run_main_thread_jobs
+    mutex dependents_mutex;
+    vector<shared_ptr<job>> dependents;
+};
+typedef shared_ptr<job> job_handle;
+
+// Work stealing scheduler. Every worker owns a deque, it pushes and pops its own
+// jobs at the back and steals from the front of the others when it runs dry.
+// Jobs can depend on other jobs and only start once all of those have finished.
+// Jobs created with create_main_thread_job run on the thread that calls
+// run_main_thread_jobs, which is where anything touching GL has to go.
+// That has to be the thread that created the job system, it also runs them while it waits.
+// Threads that are not workers only run their own jobs while waiting, never stolen ones,
+// so the render thread does not pick up work a loader thread queued.
+class JOB_SYSTEM {
+    public:
+        JOB_SYSTEM(unsigned int n_workers);
+        ~JOB_SYSTEM();
+        job_handle create_job(function<void()> work);
+        job_handle create_main_thread_job(function<void()> work);
+        void add_dependency(job_handle job, job_handle depends_on);
+        void submit(job_handle job);
+        job_handle run(function<void()> work);
+        void wait(job_handle job);
+        void parallel_for(unsigned int begin, unsigned int end, unsigned int grain_size,
+            function<void(unsigned int, unsigned int)> work);
+        void run_main_thread_jobs();
+        unsigned int get_worker_count();
+
+    private:
+        struct worker_queue {
+            mutex queue_mutex;
+            deque<job_handle> jobs;
+        };
+
+        vector<thread> workers;
+        // One per worker, then one for the main thread and one shared by all other threads
+        vector<unique_ptr<worker_queue>> queues;
+        thread::id main_thread_id;
+        mutex main_mutex;
+        deque<job_handle> main_jobs;
+        mutex sleep_mutex;
+        condition_variable wake_up;
+        condition_variable job_finished; // Also signalled when a main thread job is queued
+        atomic<int> waiters;
+        atomic<int> queued_jobs;
+        atomic<bool> stopping;
+
+        void worker_loop(unsigned int index);
+        unsigned int get_queue_index();
+        void push_ready(job_handle job);
+        void notify_waiters();
+        job_handle pop_or_steal(unsigned int index, bool steal);
+        void execute(job_handle job);
+};
+
+#endif
@@ -0,0 +1,104 @@
+#include "predicates.hpp"
+
+#include <cmath>
+#include <cfloat>
+
+// Half an ulp of 1.0, the relative rounding error of a single operation
+static const double epsilon = DBL_EPSILON / 2.0;
+// Error bound of the plain evaluation of orient2d relative to |detleft| + |detright|
+static const double orient_error_bound = (3.0 + 16.0 * epsilon) * epsilon;
+
+// a + b = sum + error exactly
+static inline void two_sum(double a, double b, double& sum, double& error) {
+    sum = a + b;
+    double b_virtual = sum - a;
+    double a_virtual = sum - b_virtual;
+    double b_round = b - b_virtual;
+    double a_round = a - a_virtual;
+    error = a_round + b_round;
+}
+
+// a * b = product + error exactly
+static inline void two_product(double a, double b, double& product, double& error) {
+    product = a * b;
+    error = fma(a, b, -product);
+}
+
+// Adds b to an expansion (components in increasing magnitude, no overlap),
+// zero components are dropped. Returns the new length.
+static int grow_expansion(int length, double* expansion, double b) {
+    double q = b;
+    int result_length = 0;
+    for (int i = 0; i < length; i++) {
+        double h;
+        two_sum(q, expansion[i], q, h);
+        if (h != 0.0) {
+            expansion[result_length++] = h;
+        }
+    }
+    if (q != 0.0 || result_length == 0) {
+        expansion[result_length++] = q;
+    }
+    return result_length;
+}
+
+double orient2d_exact(double ax, double ay, double bx, double by, double cx, double cy) {
+    // Expanded determinant, each product is exact as a pair of doubles
+    double terms[6][2];
+    two_product(ax, by, terms[0][0], terms[0][1]);
+    two_product(-ax, cy, terms[1][0], terms[1][1]);
+    two_product(-ay, bx, terms[2][0], terms[2][1]);
+    two_product(ay, cx, terms[3][0], terms[3][1]);
+    two_product(bx, cy, terms[4][0], terms[4][1]);
+    two_product(-by, cx, terms[5][0], terms[5][1]);
+
+    double expansion[12];
+    int length = 0;
+    for (int i = 0; i < 6; i++) {
+        for (int j = 0; j < 2; j++) {
+            length = grow_expansion(length, expansion, terms[i][j]);
+        }
+    }
+    // The largest component has the sign of the whole sum
+    return expansion[length - 1];
+}
+
+double orient2d(double ax, double ay, double bx, double by, double cx, double cy) {
+    double det_left = (ax - cx) * (by - cy);
+    double det_right = (ay - cy) * (bx - cx);
+    double det = det_left - det_right;
+
+    // Opposite signs can not cancel, the sign is always right
+    double det_sum;
+    if (det_left > 0.0) {
+        if (det_right <= 0.0) {
+            return det;
+        }
+        det_sum = det_left + det_right;
+    } else if (det_left < 0.0) {
+        if (det_right >= 0.0) {
+            return det;
+        }
+        det_sum = -det_left - det_right;
+    } else {
+        return det;
+    }
+
+    if (fabs(det) >= orient_error_bound * det_sum) {
+        return det;
+    }
+    return orient2d_exact(ax, ay, bx, by, cx, cy);
+}
+
+bool point_in_triangle(double ax, double ay, double bx, double by, double cx, double cy, double px, double py) {
+    // Inside or on an edge when no two of the signs disagree, most points fail early
+    double ab = orient2d(ax, ay, bx, by, px, py);
+    double bc = orient2d(bx, by, cx, cy, px, py);
+    if ((ab < 0.0 && bc > 0.0) || (ab > 0.0 && bc < 0.0)) {
+        return false;
+    }
+    double ca = orient2d(cx, cy, ax, ay, px, py);
+    bool has_negative = ab < 0.0 || bc < 0.0 || ca < 0.0;
+    bool has_positive = ab > 0.0 || bc > 0.0 || ca > 0.0;
+    return !(has_negative && has_positive);
+}
@@ -0,0 +1,20 @@
+#ifndef PREDICATES_H
+#define PREDICATES_H
+
+// Robust geometric predicates on double coordinates (floats convert exactly).
+// A cheap floating point evaluation is used when its error bound proves the sign,
+// only nearly degenerate inputs fall back to exact expansion arithmetic
+// (after Shewchuk, "Adaptive Precision Floating-Point Arithmetic and Fast
+// Robust Geometric Predicates"). Do not build this file with -ffast-math.
+
+// Positive when a, b, c turn counter clockwise, negative when clockwise and
+// exactly zero when they are collinear. Only the sign is exact.
+double orient2d(double ax, double ay, double bx, double by, double cx, double cy);
+
+// Same as orient2d but always takes the exact path, for testing the filter
+double orient2d_exact(double ax, double ay, double bx, double by, double cx, double cy);
+
+// True when p is inside triangle abc or on its boundary, for either winding
+bool point_in_triangle(double ax, double ay, double bx, double by, double cx, double cy, double px, double py);
+
+#endif
@@ -0,0 +1,96 @@
+#include "rect_packer.hpp"
+
+#include <limits.h>
+
+RECT_PACKER::RECT_PACKER(int width, int height) {
+    this->width = width;
+    this->height = height;
+    reset();
+}
+
+void RECT_PACKER::reset() {
+    skyline.clear();
+    skyline_node node = {0, 0, width};
+    skyline.push_back(node);
+    used_area = 0;
+}
+
+// Lowest y a rectangle can sit at with its left edge on the node, -1 when it does not fit
+int RECT_PACKER::fit(unsigned int node, int width, int height) {
+    int x = skyline[node].x;
+    if (x + width > this->width) {
+        return -1;
+    }
+    int y = 0;
+    int remaining = width;
+    for (unsigned int i = node; remaining > 0; i++) {
+        if (skyline[i].y > y) {
+            y = skyline[i].y;
+        }
+        if (y + height > this->height) {
+            return -1;
+        }
+        remaining -= skyline[i].width;
+    }
+    return y;
+}
+
+bool RECT_PACKER::pack(int width, int height, packed_rect& result) {
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+
+    // Lowest top edge wins, the narrower node breaks ties so gaps get filled first
+    int best_node = -1;
+    int best_y = INT_MAX;
+    int best_width = INT_MAX;
+    for (unsigned int i = 0; i < skyline.size(); i++) {
+        int y = fit(i, width, height);
+        if (y >= 0 && (y + height < best_y || (y + height == best_y && skyline[i].width < best_width))) {
+            best_node = i;
+            best_y = y + height;
+            best_width = skyline[i].width;
+        }
+    }
+    if (best_node < 0) {
+        return false;
+    }
+
+    result.x = skyline[best_node].x;
+    result.y = best_y - height;
+    result.width = width;
+    result.height = height;
+    used_area += (long)width * height;
+
+    // The new rectangle becomes a node, the ones it covers shrink or go away
+    skyline_node node = {result.x, best_y, width};
+    skyline.insert(skyline.begin() + best_node, node);
+    unsigned int i = best_node + 1;
+    while (i < skyline.size()) {
+        int covered = skyline[i - 1].x + skyline[i - 1].width - skyline[i].x;
+        if (covered <= 0) {
+            break;
+        }
+        if (covered < skyline[i].width) {
+            skyline[i].x += covered;
+            skyline[i].width -= covered;
+            break;
+        }
+        skyline.erase(skyline.begin() + i);
+    }
+
+    // Neighbours at the same height are one node
+    for (i = 0; i + 1 < skyline.size(); ) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        } else {
+            i++;
+        }
+    }
+    return true;
+}
+
+float RECT_PACKER::get_occupancy() {
+    return (float)used_area / ((float)width * height);
+}
@@ -0,0 +1,39 @@
+#ifndef RECT_PACKER_H
+#define RECT_PACKER_H
+
+#include <vector>
+using namespace std;
+
+struct packed_rect {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+// Skyline bottom left packer, rectangles are placed one at a time as they come in
+// so an atlas can keep growing at runtime. It only hands out positions, no pixels.
+class RECT_PACKER {
+    public:
+        RECT_PACKER(int width, int height);
+        bool pack(int width, int height, packed_rect& result);
+        void reset();
+        float get_occupancy();
+
+    private:
+        // Top edge of the packed area, from left to right
+        struct skyline_node {
+            int x;
+            int y;
+            int width;
+        };
+
+        int width;
+        int height;
+        long used_area;
+        vector<skyline_node> skyline;
+
+        int fit(unsigned int node, int width, int height);
+};
+
+#endif
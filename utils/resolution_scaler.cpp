@@ -0,0 +1,52 @@
+#include "resolution_scaler.hpp"
+
+#include <math.h>
+
+// Scale steps, finer steps would resize the viewport every few frames for nothing
+#define SCALE_STEP 0.025f
+#define RAISE_LIMIT 0.05f
+#define LOWER_LIMIT 0.2f
+// Only raise when there is clearly room, stops it from bouncing around the budget
+#define RAISE_HEADROOM 0.85
+// Frames to wait after a change, timer results arrive a few frames late
+#define COOLDOWN_FRAMES 30
+
+RESOLUTION_SCALER::RESOLUTION_SCALER(float min_scale, float max_scale, double budget_fraction) {
+    this->min_scale = min_scale;
+    this->max_scale = max_scale;
+    this->budget_fraction = budget_fraction;
+    scale = max_scale;
+    smoothed_time = 0.0;
+    cooldown = 0;
+}
+
+float RESOLUTION_SCALER::update(double scene_time, double frame_period) {
+    smoothed_time = smoothed_time == 0.0 ? scene_time : 0.9 * smoothed_time + 0.1 * scene_time;
+    if (cooldown > 0) {
+        cooldown--;
+        return scale;
+    }
+
+    double budget = frame_period * budget_fraction;
+    float ideal = scale * sqrt(budget / smoothed_time);
+    float next = scale;
+    if (smoothed_time > budget) {
+        next = fmaxf(ideal, scale - LOWER_LIMIT);
+    } else if (smoothed_time < budget * RAISE_HEADROOM) {
+        next = fminf(ideal, scale + RAISE_LIMIT);
+    }
+    next = roundf(next / SCALE_STEP) * SCALE_STEP;
+    next = next < min_scale ? min_scale : (next > max_scale ? max_scale : next);
+
+    if (next != scale) {
+        // Expect the time to follow the pixel count until new measurements come in
+        smoothed_time *= (next * next) / (scale * scale);
+        scale = next;
+        cooldown = COOLDOWN_FRAMES;
+    }
+    return scale;
+}
+
+float RESOLUTION_SCALER::get_scale() {
+    return scale;
+}
@@ -0,0 +1,23 @@
+#ifndef RESOLUTION_SCALER_H
+#define RESOLUTION_SCALER_H
+
+// Picks the render scale (fraction of the window size per axis) that keeps the measured
+// scene time inside a share of the frame period. Fill cost goes with the pixel count,
+// so the scale moves with the square root of the time ratio. It drops right away when
+// over budget and climbs back in small steps, waiting a while after every change.
+class RESOLUTION_SCALER {
+    public:
+        RESOLUTION_SCALER(float min_scale, float max_scale, double budget_fraction);
+        float update(double scene_time, double frame_period);
+        float get_scale();
+
+    private:
+        float scale;
+        float min_scale;
+        float max_scale;
+        double budget_fraction;
+        double smoothed_time;
+        int cooldown;
+};
+
+#endif
@@ -0,0 +1,273 @@
+#include "scene_file.hpp"
+#include "../shapes/mesh_optimizer.hpp"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+SCENE_FILE::SCENE_FILE() {
+    data = NULL;
+    size = 0;
+}
+
+SCENE_FILE::~SCENE_FILE() {
+    close();
+}
+
+bool SCENE_FILE::open(const char* path) {
+    close();
+
+    int file = ::open(path, O_RDONLY);
+    if (file < 0) {
+        fprintf(stderr, "ERROR: could not open scene file %s\n", path);
+        return false;
+    }
+    struct stat file_stat;
+    if (fstat(file, &file_stat) != 0 || (size_t)file_stat.st_size < sizeof(scene_header)) {
+        fprintf(stderr, "ERROR: scene file %s is too small\n", path);
+        ::close(file);
+        return false;
+    }
+
+    size = file_stat.st_size;
+    data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+    // The mapping keeps its own reference to the file
+    ::close(file);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "ERROR: could not map scene file %s\n", path);
+        data = NULL;
+        size = 0;
+        return false;
+    }
+    // Everything is read front to back exactly once on upload. Advice values are not flags, one call each
+    madvise(data, size, MADV_SEQUENTIAL);
+    madvise(data, size, MADV_WILLNEED);
+
+    // The header, section table and shape records are checked, vertex and index data are used as they are
+    const scene_header* header = get_header();
+    size_t table_end = sizeof(scene_header) + header->n_sections * sizeof(scene_section);
+    if (header->magic != SCENE_MAGIC || header->version != SCENE_VERSION ||
+        header->file_size != size || table_end > size) {
+        fprintf(stderr, "ERROR: %s is not a version %i scene file\n", path, SCENE_VERSION);
+        close();
+        return false;
+    }
+    const scene_section* sections = (const scene_section*)(header + 1);
+    for (uint32_t i = 0; i < header->n_sections; i++) {
+        // Offset and size are checked one by one, their sum can wrap around for a broken header
+        if (sections[i].offset % SCENE_SECTION_ALIGNMENT != 0 ||
+            sections[i].offset > size || sections[i].size > size - sections[i].offset) {
+            fprintf(stderr, "ERROR: scene file %s has a broken section table\n", path);
+            close();
+            return false;
+        }
+    }
+    if (!check_shapes()) {
+        fprintf(stderr, "ERROR: scene file %s has shapes or levels outside of its vertex or index sections\n", path);
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Levels have to stay inside their shape, the shape check below covers the rest
+static bool check_lods(const scene_shape_record& shape, const scene_shape_lods& lods) {
+    if (lods.n_levels < 1 || lods.n_levels > SCENE_MAX_LODS) {
+        return false;
+    }
+    for (uint32_t i = 0; i < lods.n_levels; i++) {
+        const scene_lod_level& level = lods.levels[i];
+        if ((uint64_t)level.first_index + level.index_count > shape.index_count ||
+            (uint64_t)level.first_vertex + level.vertex_count > shape.vertex_count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Every shape has to stay inside the sections, otherwise uploads and draws read past them
+bool SCENE_FILE::check_shapes() {
+    size_t positions_size, colors_size, shapes_size, lods_size, n_indices;
+    unsigned int index_size;
+    get_section(SCENE_SECTION_POSITIONS, &positions_size);
+    const void* colors = get_section(SCENE_SECTION_COLORS, &colors_size);
+    get_indices(&n_indices, &index_size);
+    const scene_shape_record* shapes = (const scene_shape_record*)get_section(SCENE_SECTION_SHAPES, &shapes_size);
+    const scene_shape_lods* lods = (const scene_shape_lods*)get_section(SCENE_SECTION_LODS, &lods_size);
+    size_t n_shapes = shapes_size / sizeof(scene_shape_record);
+    if ((colors && colors_size != positions_size) || (lods && lods_size != n_shapes * sizeof(scene_shape_lods))) {
+        return false;
+    }
+    uint64_t n_vertices = positions_size / (3 * sizeof(float));
+    for (size_t i = 0; i < n_shapes; i++) {
+        if (shapes[i].base_vertex < 0 ||
+            (uint64_t)shapes[i].base_vertex + shapes[i].vertex_count > n_vertices ||
+            (uint64_t)shapes[i].first_index + shapes[i].index_count > n_indices ||
+            (lods && !check_lods(shapes[i], lods[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SCENE_FILE::close() {
+    if (data) {
+        munmap(data, size);
+    }
+    data = NULL;
+    size = 0;
+}
+
+const scene_header* SCENE_FILE::get_header() {
+    return (const scene_header*)data;
+}
+
+const void* SCENE_FILE::get_section(scene_section_type type, size_t* section_size) {
+    const scene_header* header = get_header();
+    const scene_section* sections = (const scene_section*)(header + 1);
+    for (uint32_t i = 0; i < header->n_sections; i++) {
+        if (sections[i].type == (uint32_t)type) {
+            *section_size = sections[i].size;
+            return (const char*)data + sections[i].offset;
+        }
+    }
+    *section_size = 0;
+    return NULL;
+}
+
+const void* SCENE_FILE::get_indices(size_t* n_indices, unsigned int* index_size) {
+    size_t section_size;
+    const void* indices = get_section(SCENE_SECTION_INDICES_16, &section_size);
+    *index_size = 2;
+    if (!indices) {
+        indices = get_section(SCENE_SECTION_INDICES, &section_size);
+        *index_size = 4;
+    }
+    *n_indices = section_size / *index_size;
+    return indices;
+}
+
+static uint64_t align_offset(uint64_t offset) {
+    return (offset + SCENE_SECTION_ALIGNMENT - 1) / SCENE_SECTION_ALIGNMENT * SCENE_SECTION_ALIGNMENT;
+}
+
+bool make_scene_lods(const mesh_data& mesh, scene_shape_lods& lods) {
+    memset(&lods, 0, sizeof(lods));
+    lods.n_levels = get_mesh_lod_count(mesh);
+    if (lods.n_levels > SCENE_MAX_LODS) {
+        fprintf(stderr, "ERROR: mesh with %u levels of detail, scene files hold %i\n", lods.n_levels, SCENE_MAX_LODS);
+        return false;
+    }
+    if (mesh.lods.empty()) {
+        lods.levels[0].index_count = mesh.indices.size();
+        lods.levels[0].vertex_count = mesh.positions.size() / 3;
+        return true;
+    }
+    for (uint32_t i = 0; i < lods.n_levels; i++) {
+        lods.levels[i].first_index = mesh.lods[i].first_index;
+        lods.levels[i].index_count = mesh.lods[i].index_count;
+        lods.levels[i].first_vertex = mesh.lods[i].first_vertex;
+        lods.levels[i].vertex_count = mesh.lods[i].vertex_count;
+        lods.levels[i].error = mesh.lods[i].error;
+    }
+    return true;
+}
+
+bool write_scene_file(const char* path, const vector<mesh_data>& meshes) {
+    // Concatenate all meshes the same way the mesh pool would
+    vector<float> positions;
+    vector<float> colors;
+    vector<uint32_t> indices;
+    vector<scene_shape_record> shapes;
+    vector<scene_shape_lods> shape_lods;
+    unsigned int index_size = 2;
+    for (const mesh_data& mesh : meshes) {
+        scene_shape_lods lods;
+        if (!make_scene_lods(mesh, lods)) {
+            return false;
+        }
+        // Indices are local to each level, so they only need to address the biggest one
+        for (uint32_t i = 0; i < lods.n_levels; i++) {
+            index_size = max(index_size, choose_index_size(lods.levels[i].vertex_count));
+        }
+        shape_lods.push_back(lods);
+
+        aabb bounds = get_mesh_bounds(mesh);
+        scene_shape_record record;
+        record.first_index = indices.size();
+        record.index_count = mesh.indices.size();
+        record.base_vertex = positions.size() / 3;
+        record.vertex_count = mesh.positions.size() / 3;
+        record.bounds[0] = bounds.min_x;
+        record.bounds[1] = bounds.min_y;
+        record.bounds[2] = bounds.max_x;
+        record.bounds[3] = bounds.max_y;
+        shapes.push_back(record);
+
+        positions.insert(positions.end(), mesh.positions.begin(), mesh.positions.end());
+        colors.insert(colors.end(), mesh.colors.begin(), mesh.colors.end());
+        indices.insert(indices.end(), mesh.indices.begin(), mesh.indices.end());
+    }
+
+    vector<uint16_t> short_indices;
+    if (index_size == 2) {
+        short_indices.resize(indices.size());
+        narrow_indices(indices.data(), indices.size(), short_indices.data());
+    }
+
+    const int n_sections = 5;
+    const void* section_data[n_sections] = {
+        positions.data(), colors.data(),
+        index_size == 2 ? (const void*)short_indices.data() : (const void*)indices.data(),
+        shapes.data(), shape_lods.data()
+    };
+    scene_section sections[n_sections] = {
+        {SCENE_SECTION_POSITIONS, 0, 0, positions.size() * sizeof(float)},
+        {SCENE_SECTION_COLORS, 0, 0, colors.size() * sizeof(float)},
+        {index_size == 2 ? SCENE_SECTION_INDICES_16 : SCENE_SECTION_INDICES, 0, 0, indices.size() * index_size},
+        {SCENE_SECTION_SHAPES, 0, 0, shapes.size() * sizeof(scene_shape_record)},
+        {SCENE_SECTION_LODS, 0, 0, shape_lods.size() * sizeof(scene_shape_lods)},
+    };
+    uint64_t offset = sizeof(scene_header) + sizeof(sections);
+    for (int i = 0; i < n_sections; i++) {
+        sections[i].offset = align_offset(offset);
+        offset = sections[i].offset + sections[i].size;
+    }
+
+    scene_header header;
+    header.magic = SCENE_MAGIC;
+    header.version = SCENE_VERSION;
+    header.n_sections = n_sections;
+    header.n_vertices = positions.size() / 3;
+    header.n_indices = indices.size();
+    header.n_shapes = shapes.size();
+    header.file_size = offset;
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "ERROR: could not open scene file %s for writing\n", path);
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && fwrite(sections, sizeof(sections), 1, file) == 1;
+    for (int i = 0; i < n_sections && ok; i++) {
+        // Zero padding up to the aligned section start
+        ok = fseek(file, sections[i].offset, SEEK_SET) == 0;
+        if (ok && sections[i].size > 0) {
+            ok = fwrite(section_data[i], sections[i].size, 1, file) == 1;
+        }
+    }
+    // Make sure the file is as long as the header claims, even if the last section is empty
+    if (ok && (uint64_t)ftell(file) < header.file_size) {
+        ok = fseek(file, header.file_size - 1, SEEK_SET) == 0 && fputc(0, file) != EOF;
+    }
+    fclose(file);
+    if (!ok) {
+        fprintf(stderr, "ERROR: could not write scene file %s\n", path);
+    }
+    return ok;
+}
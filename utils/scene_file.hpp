@@ -0,0 +1,99 @@
+#ifndef SCENE_FILE_H
+#define SCENE_FILE_H
+
+#include "../shapes/mesh.hpp"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+using namespace std;
+
+// Binary scene layout, everything little endian and already in the layout the
+// mesh pool uploads, so a loaded file is handed to GL without being parsed:
+//   scene_header
+//   scene_section[n_sections]
+//   sections, each starting on a SCENE_SECTION_ALIGNMENT boundary
+#define SCENE_MAGIC 0x4e435353 // "SSCN"
+#define SCENE_VERSION 3
+#define SCENE_SECTION_ALIGNMENT 4096
+#define SCENE_MAX_LODS 5
+
+enum scene_section_type {
+    SCENE_SECTION_POSITIONS = 1, // float x, y, z per vertex
+    SCENE_SECTION_COLORS = 2, // float r, g, b per vertex
+    SCENE_SECTION_INDICES = 3, // uint32 triangle list, local to each shape
+    SCENE_SECTION_INDICES_16 = 5, // Same as above as uint16, used when every shape has at most 65536 vertices
+    SCENE_SECTION_SHAPES = 4, // scene_shape_record per shape
+    SCENE_SECTION_LODS = 6, // scene_shape_lods per shape, in the same order, optional
+};
+
+struct scene_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t n_sections;
+    uint32_t n_vertices;
+    uint32_t n_indices;
+    uint32_t n_shapes;
+    uint64_t file_size;
+};
+
+struct scene_section {
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t size;
+};
+
+// First index and base vertex are relative to the start of the index/vertex sections
+struct scene_shape_record {
+    uint32_t first_index;
+    uint32_t index_count;
+    int32_t base_vertex;
+    uint32_t vertex_count;
+    float bounds[4]; // min x, min y, max x, max y
+};
+
+// A shape's index and vertex ranges hold all of its levels one after another. Offsets
+// are relative to the shape, indices are local to the level's first vertex.
+struct scene_lod_level {
+    uint32_t first_index;
+    uint32_t index_count;
+    uint32_t first_vertex;
+    uint32_t vertex_count;
+    float error;
+};
+
+// Finest level first, without the section every shape is a single level
+struct scene_shape_lods {
+    uint32_t n_levels;
+    scene_lod_level levels[SCENE_MAX_LODS];
+};
+
+static_assert(sizeof(scene_header) == 32, "scene_header layout changed");
+static_assert(sizeof(scene_section) == 24, "scene_section layout changed");
+static_assert(sizeof(scene_shape_record) == 32, "scene_shape_record layout changed");
+static_assert(sizeof(scene_shape_lods) == 104, "scene_shape_lods layout changed");
+
+// Read only memory mapping of a scene file, the section pointers stay valid until close
+class SCENE_FILE {
+    public:
+        SCENE_FILE();
+        ~SCENE_FILE();
+        bool open(const char* path);
+        void close();
+        const scene_header* get_header();
+        const void* get_section(scene_section_type type, size_t* size);
+        const void* get_indices(size_t* n_indices, unsigned int* index_size);
+
+    private:
+        void* data;
+        size_t size;
+
+        bool check_shapes();
+};
+
+// Level records of a mesh, false when it has more than SCENE_MAX_LODS levels
+bool make_scene_lods(const mesh_data& mesh, scene_shape_lods& lods);
+bool write_scene_file(const char* path, const vector<mesh_data>& meshes);
+
+#endif
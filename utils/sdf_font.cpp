@@ -0,0 +1,256 @@
+#include "sdf_font.hpp"
+
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+
+// Classic 5x7 font, one byte per column, the lowest bit is the top row
+static const unsigned char font_5x7[(SDF_LAST_CHAR - SDF_FIRST_CHAR + 1) * SDF_FONT_WIDTH] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, // ' '
+    0x00, 0x00, 0x5F, 0x00, 0x00, // !
+    0x00, 0x07, 0x00, 0x07, 0x00, // "
+    0x14, 0x7F, 0x14, 0x7F, 0x14, // #
+    0x24, 0x2A, 0x7F, 0x2A, 0x12, // $
+    0x23, 0x13, 0x08, 0x64, 0x62, // %
+    0x36, 0x49, 0x55, 0x22, 0x50, // &
+    0x00, 0x05, 0x03, 0x00, 0x00, // '
+    0x00, 0x1C, 0x22, 0x41, 0x00, // (
+    0x00, 0x41, 0x22, 0x1C, 0x00, // )
+    0x08, 0x2A, 0x1C, 0x2A, 0x08, // *
+    0x08, 0x08, 0x3E, 0x08, 0x08, // +
+    0x00, 0x50, 0x30, 0x00, 0x00, // ,
+    0x08, 0x08, 0x08, 0x08, 0x08, // -
+    0x00, 0x60, 0x60, 0x00, 0x00, // .
+    0x20, 0x10, 0x08, 0x04, 0x02, // /
+    0x3E, 0x51, 0x49, 0x45, 0x3E, // 0
+    0x00, 0x42, 0x7F, 0x40, 0x00, // 1
+    0x42, 0x61, 0x51, 0x49, 0x46, // 2
+    0x21, 0x41, 0x45, 0x4B, 0x31, // 3
+    0x18, 0x14, 0x12, 0x7F, 0x10, // 4
+    0x27, 0x45, 0x45, 0x45, 0x39, // 5
+    0x3C, 0x4A, 0x49, 0x49, 0x30, // 6
+    0x01, 0x71, 0x09, 0x05, 0x03, // 7
+    0x36, 0x49, 0x49, 0x49, 0x36, // 8
+    0x06, 0x49, 0x49, 0x29, 0x1E, // 9
+    0x00, 0x36, 0x36, 0x00, 0x00, // :
+    0x00, 0x56, 0x36, 0x00, 0x00, // ;
+    0x08, 0x14, 0x22, 0x41, 0x00, // <
+    0x14, 0x14, 0x14, 0x14, 0x14, // =
+    0x00, 0x41, 0x22, 0x14, 0x08, // >
+    0x02, 0x01, 0x51, 0x09, 0x06, // ?
+    0x32, 0x49, 0x79, 0x41, 0x3E, // @
+    0x7E, 0x11, 0x11, 0x11, 0x7E, // A
+    0x7F, 0x49, 0x49, 0x49, 0x36, // B
+    0x3E, 0x41, 0x41, 0x41, 0x22, // C
+    0x7F, 0x41, 0x41, 0x22, 0x1C, // D
+    0x7F, 0x49, 0x49, 0x49, 0x41, // E
+    0x7F, 0x09, 0x09, 0x09, 0x01, // F
+    0x3E, 0x41, 0x49, 0x49, 0x7A, // G
+    0x7F, 0x08, 0x08, 0x08, 0x7F, // H
+    0x00, 0x41, 0x7F, 0x41, 0x00, // I
+    0x20, 0x40, 0x41, 0x3F, 0x01, // J
+    0x7F, 0x08, 0x14, 0x22, 0x41, // K
+    0x7F, 0x40, 0x40, 0x40, 0x40, // L
+    0x7F, 0x02, 0x0C, 0x02, 0x7F, // M
+    0x7F, 0x04, 0x08, 0x10, 0x7F, // N
+    0x3E, 0x41, 0x41, 0x41, 0x3E, // O
+    0x7F, 0x09, 0x09, 0x09, 0x06, // P
+    0x3E, 0x41, 0x51, 0x21, 0x5E, // Q
+    0x7F, 0x09, 0x19, 0x29, 0x46, // R
+    0x46, 0x49, 0x49, 0x49, 0x31, // S
+    0x01, 0x01, 0x7F, 0x01, 0x01, // T
+    0x3F, 0x40, 0x40, 0x40, 0x3F, // U
+    0x1F, 0x20, 0x40, 0x20, 0x1F, // V
+    0x3F, 0x40, 0x38, 0x40, 0x3F, // W
+    0x63, 0x14, 0x08, 0x14, 0x63, // X
+    0x07, 0x08, 0x70, 0x08, 0x07, // Y
+    0x61, 0x51, 0x49, 0x45, 0x43, // Z
+    0x00, 0x7F, 0x41, 0x41, 0x00, // [
+    0x02, 0x04, 0x08, 0x10, 0x20, // backslash
+    0x00, 0x41, 0x41, 0x7F, 0x00, // ]
+    0x04, 0x02, 0x01, 0x02, 0x04, // ^
+    0x40, 0x40, 0x40, 0x40, 0x40, // _
+    0x00, 0x01, 0x02, 0x04, 0x00, // `
+    0x20, 0x54, 0x54, 0x54, 0x78, // a
+    0x7F, 0x48, 0x44, 0x44, 0x38, // b
+    0x38, 0x44, 0x44, 0x44, 0x20, // c
+    0x38, 0x44, 0x44, 0x48, 0x7F, // d
+    0x38, 0x54, 0x54, 0x54, 0x18, // e
+    0x08, 0x7E, 0x09, 0x01, 0x02, // f
+    0x0C, 0x52, 0x52, 0x52, 0x3E, // g
+    0x7F, 0x08, 0x04, 0x04, 0x78, // h
+    0x00, 0x44, 0x7D, 0x40, 0x00, // i
+    0x20, 0x40, 0x44, 0x3D, 0x00, // j
+    0x7F, 0x10, 0x28, 0x44, 0x00, // k
+    0x00, 0x41, 0x7F, 0x40, 0x00, // l
+    0x7C, 0x04, 0x18, 0x04, 0x78, // m
+    0x7C, 0x08, 0x04, 0x04, 0x78, // n
+    0x38, 0x44, 0x44, 0x44, 0x38, // o
+    0x7C, 0x14, 0x14, 0x14, 0x08, // p
+    0x08, 0x14, 0x14, 0x18, 0x7C, // q
+    0x7C, 0x08, 0x04, 0x04, 0x08, // r
+    0x48, 0x54, 0x54, 0x54, 0x20, // s
+    0x04, 0x3F, 0x44, 0x40, 0x20, // t
+    0x3C, 0x40, 0x40, 0x20, 0x7C, // u
+    0x1C, 0x20, 0x40, 0x20, 0x1C, // v
+    0x3C, 0x40, 0x30, 0x40, 0x3C, // w
+    0x44, 0x28, 0x10, 0x28, 0x44, // x
+    0x0C, 0x50, 0x50, 0x50, 0x3C, // y
+    0x44, 0x64, 0x54, 0x4C, 0x44, // z
+    0x00, 0x08, 0x36, 0x41, 0x00, // {
+    0x00, 0x00, 0x7F, 0x00, 0x00, // |
+    0x00, 0x41, 0x36, 0x08, 0x00, // }
+    0x08, 0x04, 0x08, 0x10, 0x08, // ~
+};
+
+// The field is computed on a finer grid than the one it is stored at, so edges get sub texel distances
+#define SDF_OVERSAMPLE 4
+
+// Squared distance to the nearest zero along one row or column (Felzenszwalb and Huttenlocher)
+static void distance_transform_1d(const float* f, int n, float* d, int* v, float* z) {
+    int k = 0;
+    v[0] = 0;
+    z[0] = -INFINITY;
+    z[1] = INFINITY;
+    for (int q = 1; q < n; q++) {
+        float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        while (s <= z[k]) {
+            k--;
+            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = INFINITY;
+    }
+    k = 0;
+    for (int q = 0; q < n; q++) {
+        while (z[k + 1] < q) {
+            k++;
+        }
+        d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+    }
+}
+
+// Distance from every pixel to the nearest pixel where inside equals target
+static vector<float> distance_transform(const vector<bool>& inside, int width, int height, bool target) {
+    const float far = 1e20f;
+    vector<float> grid(width * height);
+    for (int i = 0; i < width * height; i++) {
+        grid[i] = inside[i] == target ? 0.0f : far;
+    }
+    int n = max(width, height);
+    vector<float> f(n), d(n), z(n + 1);
+    vector<int> v(n);
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < height; y++) {
+            f[y] = grid[y * width + x];
+        }
+        distance_transform_1d(f.data(), height, d.data(), v.data(), z.data());
+        for (int y = 0; y < height; y++) {
+            grid[y * width + x] = d[y];
+        }
+    }
+    for (int y = 0; y < height; y++) {
+        distance_transform_1d(&grid[y * width], width, d.data(), v.data(), z.data());
+        for (int x = 0; x < width; x++) {
+            grid[y * width + x] = sqrtf(d[x]);
+        }
+    }
+    return grid;
+}
+
+static image make_sdf_glyph(char c) {
+    const unsigned char* columns = &font_5x7[(c - SDF_FIRST_CHAR) * SDF_FONT_WIDTH];
+
+    // Rasterize the glyph with its border on the fine grid
+    int fine = SDF_CELL_SCALE * SDF_OVERSAMPLE;
+    int border = SDF_SPREAD * SDF_OVERSAMPLE;
+    int width = SDF_FONT_WIDTH * fine + 2 * border;
+    int height = SDF_FONT_HEIGHT * fine + 2 * border;
+    vector<bool> inside(width * height, false);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int column = (x - border) / fine;
+            int row = (y - border) / fine;
+            if (x >= border && y >= border && column < SDF_FONT_WIDTH && row < SDF_FONT_HEIGHT) {
+                inside[y * width + x] = (columns[column] >> row) & 1;
+            }
+        }
+    }
+    vector<float> to_inside = distance_transform(inside, width, height, true);
+    vector<float> to_outside = distance_transform(inside, width, height, false);
+
+    // Sample the texel centers, 0.5 is the edge and the field reaches SDF_SPREAD texels either way
+    image glyph = make_image(SDF_CELL_WIDTH, SDF_CELL_HEIGHT, 255, 255, 255, 0);
+    for (int y = 0; y < SDF_CELL_HEIGHT; y++) {
+        for (int x = 0; x < SDF_CELL_WIDTH; x++) {
+            int i = (y * SDF_OVERSAMPLE + SDF_OVERSAMPLE / 2) * width + x * SDF_OVERSAMPLE + SDF_OVERSAMPLE / 2;
+            float distance = (to_outside[i] - to_inside[i]) / SDF_OVERSAMPLE;
+            float value = 0.5f + 0.5f * distance / SDF_SPREAD;
+            value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+            glyph.pixels[(y * SDF_CELL_WIDTH + x) * 4 + 3] = (unsigned char)(value * 255.0f + 0.5f);
+        }
+    }
+    return glyph;
+}
+
+image make_sdf_glyph_sheet() {
+    int n_glyphs = SDF_LAST_CHAR - SDF_FIRST_CHAR + 1;
+    int rows = (n_glyphs + SDF_SHEET_COLUMNS - 1) / SDF_SHEET_COLUMNS;
+    image sheet = make_image(SDF_SHEET_COLUMNS * SDF_CELL_WIDTH, rows * SDF_CELL_HEIGHT, 255, 255, 255, 0);
+    for (int i = 0; i < n_glyphs; i++) {
+        image glyph = make_sdf_glyph(SDF_FIRST_CHAR + i);
+        int cell_x = (i % SDF_SHEET_COLUMNS) * SDF_CELL_WIDTH;
+        int cell_y = (i / SDF_SHEET_COLUMNS) * SDF_CELL_HEIGHT;
+        for (int y = 0; y < SDF_CELL_HEIGHT; y++) {
+            copy(&glyph.pixels[y * SDF_CELL_WIDTH * 4], &glyph.pixels[(y + 1) * SDF_CELL_WIDTH * 4],
+                &sheet.pixels[((size_t)(cell_y + y) * sheet.width + cell_x) * 4]);
+        }
+    }
+    return sheet;
+}
+
+bool load_sdf_glyph_sheet(const char* cache_path, image& sheet) {
+    int n_glyphs = SDF_LAST_CHAR - SDF_FIRST_CHAR + 1;
+    int rows = (n_glyphs + SDF_SHEET_COLUMNS - 1) / SDF_SHEET_COLUMNS;
+    FILE* file = fopen(cache_path, "rb");
+    if (file) {
+        fclose(file);
+        // A sheet with other cell sizes was made by another version, build it again
+        if (load_image(cache_path, sheet) &&
+            sheet.width == SDF_SHEET_COLUMNS * SDF_CELL_WIDTH && sheet.height == rows * SDF_CELL_HEIGHT) {
+            return true;
+        }
+    }
+    sheet = make_sdf_glyph_sheet();
+    if (!save_image(cache_path, sheet)) {
+        fprintf(stderr, "ERROR: could not cache glyphs in %s\n", cache_path);
+        return false;
+    }
+    return true;
+}
+
+SDF_FONT::SDF_FONT(TEXTURE_ATLAS* atlas, const char* cache_path) {
+    image sheet;
+    load_sdf_glyph_sheet(cache_path, sheet);
+
+    // Every glyph gets its own atlas slot, so they can share a page with sprites
+    image glyph = make_image(SDF_CELL_WIDTH, SDF_CELL_HEIGHT, 0, 0, 0, 0);
+    for (int i = 0; i <= SDF_LAST_CHAR - SDF_FIRST_CHAR; i++) {
+        int cell_x = (i % SDF_SHEET_COLUMNS) * SDF_CELL_WIDTH;
+        int cell_y = (i / SDF_SHEET_COLUMNS) * SDF_CELL_HEIGHT;
+        for (int y = 0; y < SDF_CELL_HEIGHT; y++) {
+            const unsigned char* row = &sheet.pixels[((size_t)(cell_y + y) * sheet.width + cell_x) * 4];
+            copy(row, row + SDF_CELL_WIDTH * 4, &glyph.pixels[y * SDF_CELL_WIDTH * 4]);
+        }
+        sprites[i] = atlas->add_image(glyph);
+    }
+}
+
+int SDF_FONT::get_sprite(char c) {
+    if (c < SDF_FIRST_CHAR || c > SDF_LAST_CHAR) {
+        c = '?';
+    }
+    return sprites[c - SDF_FIRST_CHAR];
+}
@@ -0,0 +1,34 @@
+#ifndef SDF_FONT_H
+#define SDF_FONT_H
+
+#include "image.hpp"
+#include "texture_atlas.hpp"
+
+// Printable ASCII from the embedded 5x7 font
+#define SDF_FIRST_CHAR 32
+#define SDF_LAST_CHAR 126
+#define SDF_FONT_WIDTH 5
+#define SDF_FONT_HEIGHT 7
+// Field texels per font pixel, and how many texels the field reaches past an edge
+#define SDF_CELL_SCALE 4
+#define SDF_SPREAD 4
+#define SDF_CELL_WIDTH (SDF_FONT_WIDTH * SDF_CELL_SCALE + 2 * SDF_SPREAD)
+#define SDF_CELL_HEIGHT (SDF_FONT_HEIGHT * SDF_CELL_SCALE + 2 * SDF_SPREAD)
+#define SDF_SHEET_COLUMNS 16
+
+// Signed distance fields of all glyphs in a grid, stored in alpha (0.5 is the edge)
+image make_sdf_glyph_sheet();
+// Loads the sheet from the cache file, or builds and writes it when there is none yet
+bool load_sdf_glyph_sheet(const char* cache_path, image& sheet);
+
+// The glyphs as sprites in an atlas, the font is monospaced so there are no other metrics
+class SDF_FONT {
+    public:
+        SDF_FONT(TEXTURE_ATLAS* atlas, const char* cache_path);
+        int get_sprite(char c);
+
+    private:
+        int sprites[SDF_LAST_CHAR - SDF_FIRST_CHAR + 1];
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "shader_preprocessor.hpp"
+
+#include <stdio.h>
+#include <ctype.h>
+#include <fstream>
+#include <sstream>
+
+static const int MAX_INCLUDE_DEPTH = 16;
+
+// Directive name when the line is a preprocessor directive, otherwise empty
+static string get_directive(const string& line, size_t* end) {
+    size_t i = line.find_first_not_of(" \t");
+    if (i == string::npos || line[i] != '#') {
+        return "";
+    }
+    i = line.find_first_not_of(" \t", i + 1);
+    if (i == string::npos) {
+        return "";
+    }
+    size_t j = i;
+    while (j < line.size() && isalpha((unsigned char)line[j])) {
+        j++;
+    }
+    *end = j;
+    return line.substr(i, j - i);
+}
+
+static string get_directory(const string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == string::npos ? "" : path.substr(0, slash + 1);
+}
+
+static void append_line_directive(shader_source& source, int line, int file) {
+    source.text += "#line " + to_string(line) + " " + to_string(file) + "\n";
+}
+
+static void append_defines(shader_source& source, const vector<string>& defines) {
+    for (size_t i = 0; i < defines.size(); i++) {
+        source.text += "#define " + defines[i] + "\n";
+    }
+}
+
+static bool append_file(const string& path, const vector<string>& defines, shader_source& source, int depth) {
+    if (depth > MAX_INCLUDE_DEPTH) {
+        fprintf(stderr, "ERROR: shader includes nested deeper than %i at %s, recursive include?\n", MAX_INCLUDE_DEPTH, path.c_str());
+        return false;
+    }
+
+    ifstream file(path.c_str());
+    if (!file) {
+        fprintf(stderr, "ERROR: could not open shader file %s\n", path.c_str());
+        return false;
+    }
+    stringstream buffer;
+    buffer << file.rdbuf();
+    string text = buffer.str();
+
+    int file_index = source.files.size();
+    source.files.push_back(path);
+    bool root = depth == 0;
+
+    // Defines go after #version, which has to come first. Without one they lead the file
+    if (root && text.find("#version") == string::npos) {
+        append_defines(source, defines);
+        append_line_directive(source, 1, file_index);
+    } else if (!root) {
+        append_line_directive(source, 1, file_index);
+    }
+
+    istringstream lines(text);
+    string line;
+    int line_number = 0;
+    while (getline(lines, line)) {
+        line_number++;
+        size_t end = 0;
+        string directive = get_directive(line, &end);
+
+        if (root && directive == "version") {
+            source.text += line + "\n";
+            append_defines(source, defines);
+            append_line_directive(source, line_number + 1, file_index);
+            continue;
+        }
+
+        if (directive == "include") {
+            size_t open = line.find('"', end);
+            size_t close = open == string::npos ? string::npos : line.find('"', open + 1);
+            if (close == string::npos) {
+                fprintf(stderr, "ERROR: %s:%i: expected #include \"file\"\n", path.c_str(), line_number);
+                return false;
+            }
+            string include_path = get_directory(path) + line.substr(open + 1, close - open - 1);
+
+            // Every file once, so shared declarations can be included from several places
+            bool included = false;
+            for (size_t i = 0; i < source.files.size(); i++) {
+                if (source.files[i] == include_path) {
+                    included = true;
+                }
+            }
+            if (!included) {
+                if (!append_file(include_path, defines, source, depth + 1)) {
+                    fprintf(stderr, "  included from %s:%i\n", path.c_str(), line_number);
+                    return false;
+                }
+            }
+            append_line_directive(source, line_number + 1, file_index);
+            continue;
+        }
+
+        source.text += line + "\n";
+    }
+    return true;
+}
+
+bool preprocess_shader(const char* path, const vector<string>& defines, shader_source& source) {
+    source.text.clear();
+    source.files.clear();
+    return append_file(path, defines, source, 0);
+}
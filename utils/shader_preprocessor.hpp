@@ -0,0 +1,20 @@
+#ifndef SHADER_PREPROCESSOR_H
+#define SHADER_PREPROCESSOR_H
+
+#include <string>
+#include <vector>
+using namespace std;
+
+// A shader with its includes pasted in. Every file gets a source string number
+// in the #line directives, so compile errors point at the right file and line.
+struct shader_source {
+    string text;
+    vector<string> files; // Index is the source string number
+};
+
+// Resolves #include "file" (relative to the including file, every file only once)
+// and puts a #define for each entry of defines ("NAME" or "NAME VALUE") right after #version.
+// Conditionals are left to the GLSL compiler, includes inside an #ifdef are always pasted in.
+bool preprocess_shader(const char* path, const vector<string>& defines, shader_source& source);
+
+#endif
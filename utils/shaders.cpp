@@ -2,17 +2,19 @@
 #include <GLFW/glfw3.h>
 
 #include "log.hpp"
+#include "shader_preprocessor.hpp"
 
 #include <stdio.h>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <vector>
 #include <assert.h>
 using namespace std;
 
 
-GLuint create_compiled_shader(string shader_str, int SHADER_TYPE) {
+GLuint create_compiled_shader(string shader_str, int SHADER_TYPE, const vector<string>& files = vector<string>()) {
     // Convert string to const char *
     const char * shader_char = shader_str.c_str();
 
@@ -27,18 +29,28 @@ GLuint create_compiled_shader(string shader_str, int SHADER_TYPE) {
     if (GL_TRUE != compile_params) {
         fprintf(stderr, "ERROR: GL shader index %i did not compile\n", shader);
         _print_shader_info_log(shader);
+        // Errors are reported as source string(line), the number says which include it was
+        for (size_t i = 0; i < files.size(); i++) {
+            fprintf(stderr, "  source string %u: %s\n", (unsigned int)i, files[i].c_str());
+        }
         exit(1);
     }
 
     return shader;
 }
 
-GLuint create_shader_program_from_strings(string vs_string, string fs_string){
-    GLuint vs = create_compiled_shader(vs_string, GL_VERTEX_SHADER);
-    GLuint fs = create_compiled_shader(fs_string, GL_FRAGMENT_SHADER);
+// Shaders of an earlier link are detached first, so a program can be linked again in place
+void link_shader_program(GLuint shader_programme, const shader_source& vs_source, const shader_source& fs_source) {
+    GLuint vs = create_compiled_shader(vs_source.text, GL_VERTEX_SHADER, vs_source.files);
+    GLuint fs = create_compiled_shader(fs_source.text, GL_FRAGMENT_SHADER, fs_source.files);
+
+    GLuint attached[2];
+    GLsizei n_attached = 0;
+    glGetAttachedShaders(shader_programme, 2, &n_attached, attached);
+    for (GLsizei i = 0; i < n_attached; i++) {
+        glDetachShader(shader_programme, attached[i]);
+    }
 
-    // Create an empty program which will serve as the complete shader program (when compiled shaders are added)
-    GLuint shader_programme = glCreateProgram();
     glAttachShader(shader_programme, vs);
     glAttachShader(shader_programme, fs);
     glLinkProgram(shader_programme);
@@ -57,34 +69,42 @@ GLuint create_shader_program_from_strings(string vs_string, string fs_string){
         _print_programme_info_log(shader_programme);
         exit(1);
     }
-
-    return shader_programme;
 }
 
-string get_shaders(const char* path) {
-    std::ifstream t(path);
-    std::stringstream buffer;
-    buffer << t.rdbuf();
-    return buffer.str();
+GLuint create_shader_program_from_sources(const shader_source& vs_source, const shader_source& fs_source) {
+    // Create an empty program which will serve as the complete shader program (when compiled shaders are added)
+    GLuint shader_programme = glCreateProgram();
+    link_shader_program(shader_programme, vs_source, fs_source);
+    return shader_programme;
 }
 
 GLuint create_shaders_from_files(
     const char* vertex_shader_filename, 
-    const char* fragment_shader_filename) {
-        string vs_string = get_shaders(vertex_shader_filename);
-        string fs_string = get_shaders(fragment_shader_filename);
-        return create_shader_program_from_strings(vs_string, fs_string);
+    const char* fragment_shader_filename,
+    const vector<string>& defines) {
+        // Both stages see the same defines, so their inputs and outputs stay matched
+        shader_source vs_source;
+        shader_source fs_source;
+        if (!preprocess_shader(vertex_shader_filename, defines, vs_source) ||
+            !preprocess_shader(fragment_shader_filename, defines, fs_source)) {
+            return 0;
+        }
+        return create_shader_program_from_sources(vs_source, fs_source);
 }
 
-void reload_shader_from_files(GLuint *program, 
+bool reload_shader_from_files(GLuint program,
     const char* vertex_shader_filename, 
-    const char* fragment_shader_filename){
+    const char* fragment_shader_filename,
+    const vector<string>& defines) {
         assert( program && vertex_shader_filename && fragment_shader_filename );
 
-        GLuint reloaded_program = create_shaders_from_files(vertex_shader_filename, fragment_shader_filename);
-
-        if (reloaded_program) {
-            glDeleteProgram(*program);
-            *program = reloaded_program;
+        // Same defines as the first build, otherwise a variant would come back as a different one
+        shader_source vs_source;
+        shader_source fs_source;
+        if (!preprocess_shader(vertex_shader_filename, defines, vs_source) ||
+            !preprocess_shader(fragment_shader_filename, defines, fs_source)) {
+            return false;
         }
-}
\ No newline at end of file
+        link_shader_program(program, vs_source, fs_source);
+        return true;
+}
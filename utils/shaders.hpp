@@ -7,16 +7,22 @@
 #include "log.hpp"
 
 #include <string>
+#include <vector>
 #include <assert.h>
 using namespace std;
 
 
+// Sources go through the shader preprocessor, returns 0 when a file could not be read
 GLuint create_shaders_from_files(
     const char* vertex_shader_filename, 
-    const char* fragment_shader_filename);
+    const char* fragment_shader_filename,
+    const vector<string>& defines = vector<string>());
 
-void reload_shader_from_files(GLuint *program, 
+// Links the program again from the files, in place so everyone holding it sees the new code.
+// Returns false and keeps the old code when a file could not be read
+bool reload_shader_from_files(GLuint program,
     const char* vertex_shader_filename, 
-    const char* fragment_shader_filename);
+    const char* fragment_shader_filename,
+    const vector<string>& defines = vector<string>());
 
 #endif
\ No newline at end of file
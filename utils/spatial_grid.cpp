@@ -0,0 +1,133 @@
+#include "spatial_grid.hpp"
+
+#include <cmath>
+
+SPATIAL_GRID::SPATIAL_GRID(float cell_size) {
+    this->cell_size = cell_size;
+    current_stamp = 0;
+}
+
+void SPATIAL_GRID::insert(unsigned int id, const aabb& bounds) {
+    if (id >= items.size()) {
+        items.resize(id + 1);
+        query_stamps.resize(id + 1, 0);
+    }
+    // Inserting an id again moves it, it must not end up in its old cells twice
+    if (items[id].active) {
+        remove_from_cells(id, items[id].cells);
+    }
+    items[id].bounds = bounds;
+    items[id].cells = get_cell_range(bounds);
+    items[id].active = true;
+    add_to_cells(id, items[id].cells);
+}
+
+void SPATIAL_GRID::update(unsigned int id, const aabb& bounds) {
+    // Removed ids stay removed until they are inserted again
+    if (id >= items.size() || !items[id].active) {
+        return;
+    }
+    item& current = items[id];
+    current.bounds = bounds;
+
+    // Small moves mostly stay inside the same cells, only rebucket when the range changes
+    cell_range range = get_cell_range(bounds);
+    if (range.min_x == current.cells.min_x && range.min_y == current.cells.min_y &&
+        range.max_x == current.cells.max_x && range.max_y == current.cells.max_y) {
+        return;
+    }
+    remove_from_cells(id, current.cells);
+    current.cells = range;
+    add_to_cells(id, range);
+}
+
+void SPATIAL_GRID::remove(unsigned int id) {
+    if (id >= items.size() || !items[id].active) {
+        return;
+    }
+    remove_from_cells(id, items[id].cells);
+    items[id].active = false;
+}
+
+void SPATIAL_GRID::query_rect(const aabb& rect, vector<unsigned int>& result) {
+    result.clear();
+    current_stamp++;
+
+    cell_range range = get_cell_range(rect);
+    for (int y = range.min_y; y <= range.max_y; y++) {
+        for (int x = range.min_x; x <= range.max_x; x++) {
+            unordered_map<int64_t, vector<unsigned int>>::iterator cell = cells.find(get_cell_key(x, y));
+            if (cell == cells.end()) {
+                continue;
+            }
+            for (unsigned int id : cell->second) {
+                if (query_stamps[id] == current_stamp) {
+                    continue;
+                }
+                query_stamps[id] = current_stamp;
+                if (aabb_overlaps(items[id].bounds, rect)) {
+                    result.push_back(id);
+                }
+            }
+        }
+    }
+}
+
+void SPATIAL_GRID::query_point(float x, float y, vector<unsigned int>& result) {
+    result.clear();
+    int cell_x = (int)floor(x / cell_size);
+    int cell_y = (int)floor(y / cell_size);
+    unordered_map<int64_t, vector<unsigned int>>::iterator cell = cells.find(get_cell_key(cell_x, cell_y));
+    if (cell == cells.end()) {
+        return;
+    }
+    for (unsigned int id : cell->second) {
+        if (aabb_contains_point(items[id].bounds, x, y)) {
+            result.push_back(id);
+        }
+    }
+}
+
+SPATIAL_GRID::cell_range SPATIAL_GRID::get_cell_range(const aabb& bounds) {
+    cell_range range;
+    range.min_x = (int)floor(bounds.min_x / cell_size);
+    range.min_y = (int)floor(bounds.min_y / cell_size);
+    range.max_x = (int)floor(bounds.max_x / cell_size);
+    range.max_y = (int)floor(bounds.max_y / cell_size);
+    return range;
+}
+
+int64_t SPATIAL_GRID::get_cell_key(int x, int y) {
+    return ((int64_t)x << 32) | (uint32_t)y;
+}
+
+void SPATIAL_GRID::add_to_cells(unsigned int id, const cell_range& range) {
+    for (int y = range.min_y; y <= range.max_y; y++) {
+        for (int x = range.min_x; x <= range.max_x; x++) {
+            cells[get_cell_key(x, y)].push_back(id);
+        }
+    }
+}
+
+void SPATIAL_GRID::remove_from_cells(unsigned int id, const cell_range& range) {
+    for (int y = range.min_y; y <= range.max_y; y++) {
+        for (int x = range.min_x; x <= range.max_x; x++) {
+            unordered_map<int64_t, vector<unsigned int>>::iterator cell = cells.find(get_cell_key(x, y));
+            if (cell == cells.end()) {
+                continue;
+            }
+            // Order inside a cell does not matter, swap with the last entry and pop
+            vector<unsigned int>& ids = cell->second;
+            for (size_t i = 0; i < ids.size(); i++) {
+                if (ids[i] == id) {
+                    ids[i] = ids.back();
+                    ids.pop_back();
+                    break;
+                }
+            }
+            if (ids.empty()) {
+                cells.erase(cell);
+            }
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "aabb.hpp"
+
+#include <unordered_map>
+#include <vector>
+#include <stdint.h>
+using namespace std;
+
+// Uniform grid over shape bounds. Only cells that exist are stored (hashed),
+// so the world can be much larger than the view without allocating empty cells.
+// Ids are small integers chosen by the caller (the mesh ids of the mesh pool).
+class SPATIAL_GRID {
+    public:
+        SPATIAL_GRID(float cell_size);
+        void insert(unsigned int id, const aabb& bounds);
+        void update(unsigned int id, const aabb& bounds);
+        void remove(unsigned int id);
+        void query_rect(const aabb& rect, vector<unsigned int>& result);
+        void query_point(float x, float y, vector<unsigned int>& result);
+
+    private:
+        struct cell_range {
+            int min_x;
+            int min_y;
+            int max_x;
+            int max_y;
+        };
+        struct item {
+            aabb bounds;
+            cell_range cells;
+            bool active;
+        };
+
+        float cell_size;
+        unordered_map<int64_t, vector<unsigned int>> cells;
+        vector<item> items;
+        // Per item stamp of the last query, avoids reporting an item once per cell
+        vector<unsigned int> query_stamps;
+        unsigned int current_stamp;
+
+        cell_range get_cell_range(const aabb& bounds);
+        int64_t get_cell_key(int x, int y);
+        void add_to_cells(unsigned int id, const cell_range& range);
+        void remove_from_cells(unsigned int id, const cell_range& range);
+};
+
+#endif
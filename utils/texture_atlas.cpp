@@ -0,0 +1,87 @@
+#include "texture_atlas.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+TEXTURE_ATLAS::TEXTURE_ATLAS(int width, int height, int mip_levels)
+    : packer(width >> mip_levels, height >> mip_levels) {
+    this->mip_levels = mip_levels;
+    alignment = 1 << mip_levels;
+    padding = alignment;
+    page = make_image(width, height, 0, 0, 0, 0);
+    dirty = true;
+}
+
+int TEXTURE_ATLAS::add_image(const image& source) {
+    // Slots are whole blocks, that keeps every slot aligned
+    int slot_width = (source.width + 2 * padding + alignment - 1) / alignment;
+    int slot_height = (source.height + 2 * padding + alignment - 1) / alignment;
+    packed_rect slot;
+    if (!packer.pack(slot_width, slot_height, slot)) {
+        fprintf(stderr, "ERROR: atlas is full, %ix%i image not added\n", source.width, source.height);
+        return -1;
+    }
+    slot.x *= alignment;
+    slot.y *= alignment;
+    slot.width *= alignment;
+    slot.height *= alignment;
+
+    // Fill the whole slot, pixels outside the image repeat the nearest edge pixel
+    for (int y = 0; y < slot.height; y++) {
+        int source_y = y - padding;
+        source_y = source_y < 0 ? 0 : (source_y >= source.height ? source.height - 1 : source_y);
+        for (int x = 0; x < slot.width; x++) {
+            int source_x = x - padding;
+            source_x = source_x < 0 ? 0 : (source_x >= source.width ? source.width - 1 : source_x);
+            memcpy(&page.pixels[((size_t)(slot.y + y) * page.width + slot.x + x) * 4],
+                &source.pixels[((size_t)source_y * source.width + source_x) * 4], 4);
+        }
+    }
+
+    packed_rect sprite = {slot.x + padding, slot.y + padding, source.width, source.height};
+    sprites.push_back(sprite);
+    dirty = true;
+    return sprites.size() - 1;
+}
+
+int TEXTURE_ATLAS::add_image_file(const char* path) {
+    image source;
+    if (!load_image(path, source)) {
+        return -1;
+    }
+    return add_image(source);
+}
+
+atlas_uv TEXTURE_ATLAS::get_uv(int sprite) {
+    const packed_rect& rect = sprites[sprite];
+    atlas_uv uv;
+    uv.u0 = (float)rect.x / page.width;
+    uv.v0 = (float)rect.y / page.height;
+    uv.u1 = (float)(rect.x + rect.width) / page.width;
+    uv.v1 = (float)(rect.y + rect.height) / page.height;
+    return uv;
+}
+
+packed_rect TEXTURE_ATLAS::get_rect(int sprite) {
+    return sprites[sprite];
+}
+
+int TEXTURE_ATLAS::get_sprite_count() {
+    return sprites.size();
+}
+
+int TEXTURE_ATLAS::get_mip_levels() {
+    return mip_levels;
+}
+
+const image& TEXTURE_ATLAS::get_page() {
+    return page;
+}
+
+bool TEXTURE_ATLAS::is_dirty() {
+    return dirty;
+}
+
+void TEXTURE_ATLAS::clear_dirty() {
+    dirty = false;
+}
@@ -0,0 +1,45 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include "image.hpp"
+#include "rect_packer.hpp"
+
+#include <vector>
+using namespace std;
+
+// Texture coordinates of a sprite, v0 is the top row of the image
+struct atlas_uv {
+    float u0;
+    float v0;
+    float u1;
+    float v1;
+};
+
+// Packs images into one RGBA page on the CPU, the GL side only uploads the result.
+// Every sprite sits in a slot aligned to 2^mip_levels texels with a border of as many
+// texels of its own edge pixels, so down to the smallest mip level sprites never
+// share a filter footprint and bilinear lookups at the edges do not bleed.
+class TEXTURE_ATLAS {
+    public:
+        TEXTURE_ATLAS(int width, int height, int mip_levels);
+        int add_image(const image& source);
+        int add_image_file(const char* path);
+        atlas_uv get_uv(int sprite);
+        packed_rect get_rect(int sprite);
+        int get_sprite_count();
+        int get_mip_levels();
+        const image& get_page();
+        bool is_dirty();
+        void clear_dirty();
+
+    private:
+        int mip_levels;
+        int alignment;
+        int padding;
+        image page;
+        RECT_PACKER packer; // Works in alignment sized blocks
+        vector<packed_rect> sprites;
+        bool dirty;
+};
+
+#endif